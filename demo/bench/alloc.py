@@ -0,0 +1,39 @@
+# Allocation benchmark
+#
+# Builds a list of small tuples, floats and strings and drops it again,
+# a few times over, and reports the time taken together with the number
+# of arenas of the small-object allocator before and after: once the
+# objects are gone, their arenas should have been given back.
+#
+# Usage: python alloc.py [count]
+
+import sys, time
+
+def report(label, msecs):
+	print label, msecs, 'msec'
+
+def build(n):
+	l = []
+	x = 0.0
+	for i in range(n):
+		x = x + 0.5
+		l.append((i, x, `i`))
+	return l
+
+def main():
+	n = 100000
+	if len(sys.argv) > 1:
+		n = eval(sys.argv[1])
+	before = sys.mallocstats()
+	t0 = time.millitimer()
+	for rep in range(5):
+		l = build(n)
+		peak = sys.mallocstats()
+		l = None
+	t1 = time.millitimer()
+	after = sys.mallocstats()
+	report('build and drop (' + `5*n` + ' tuples):', t1-t0)
+	print 'arenas before, at peak, after:', before[0], peak[0], after[0]
+	print 'arenas released:', after[3] - before[3]
+
+main()
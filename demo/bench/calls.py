@@ -0,0 +1,38 @@
+# Function call benchmark
+#
+# Builds a binary tree of tuples and walks it recursively, so the time
+# goes into Python-level calls and local variable access.
+#
+# Usage: python calls.py [depth]
+
+import sys, time
+
+def build(depth):
+	if depth = 0:
+		return None
+	left = build(depth-1)
+	right = build(depth-1)
+	return (depth, left, right)
+
+def walk(node):
+	if node = None:
+		return 0
+	depth, left, right = node
+	total = depth
+	total = total + walk(left)
+	total = total + walk(right)
+	return total
+
+def main():
+	depth = 16
+	if len(sys.argv) > 1:
+		depth = eval(sys.argv[1])
+	t0 = time.millitimer()
+	tree = build(depth)
+	t1 = time.millitimer()
+	total = walk(tree)
+	t2 = time.millitimer()
+	print 'build (depth ' + `depth` + '):', t1-t0, 'msec'
+	print 'walk (depth ' + `depth` + '):', t2-t1, 'msec'
+
+main()
@@ -0,0 +1,44 @@
+# Compiler benchmark
+#
+# Writes a synthetic module with one assignment of a distinct constant to
+# a distinct name per line, as in a generated lookup table, and times
+# how long it takes to import it.  Parsing, compiling and running the
+# module are all included, but with many distinct constants and names the
+# compiler's bookkeeping of them dominates.  Compiled code cached by an
+# earlier run is removed first, so that it is never used instead, and the
+# cache file written by the import is removed afterwards.
+#
+# Usage: python compile.py [count]
+
+import sys, time, posix
+
+def report(label, msecs):
+	print label, msecs, 'msec'
+
+def generate(filename, n):
+	fp = open(filename, 'w')
+	fp.write('# Generated by compile.py\n')
+	for i in range(n):
+		fp.write('c' + `i` + ' = ' + `i` + '\n')
+		fp.write('s' + `i` + ' = \'k' + `i` + '\'\n')
+	fp.close()
+
+def uncache(name):
+	for suffix in ['c', 'o']:
+		try: posix.unlink(name + suffix)
+		except posix.error: pass
+
+def main():
+	n = 50000
+	if len(sys.argv) > 1:
+		n = eval(sys.argv[1])
+	generate('compbench.py', n/2)
+	uncache('compbench.py')
+	t0 = time.millitimer()
+	import compbench
+	t1 = time.millitimer()
+	posix.unlink('compbench.py')
+	uncache('compbench.py')
+	report('compile (' + `n` + ' constants):', t1-t0)
+
+main()
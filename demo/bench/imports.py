@@ -0,0 +1,23 @@
+# Import benchmark
+#
+# Times importing a number of library modules, as a script that uses them
+# does at startup.  The first run compiles the modules and writes their
+# .pyc files; later runs load the compiled code from those.  Remove the
+# .pyc files in the library directory to time compilation again.
+#
+# Usage: python imports.py  (with the library on $PYTHONPATH)
+
+import time
+
+def report(label, msecs):
+	print label, msecs, 'msec'
+
+def main():
+	t0 = time.millitimer()
+	import string, dis, calendar, fnmatch, glob, path, stat, commands
+	import shutil, whrandom, util, poly, dump, statcache, dircache, cmp
+	import cmpcache, dircmp, grep, tb, rand, zmod, rect, panelparser
+	t1 = time.millitimer()
+	report('imports:', t1-t0)
+
+main()
@@ -0,0 +1,49 @@
+# Dictionary key benchmark
+#
+# Times a table indexed by int and tuple keys, against the same table
+# indexed by their backquoted string forms, which was the only way to do
+# it when dictionary keys had to be strings.
+#
+# Usage: python keys.py [count]
+
+import sys, time
+
+def report(label, msecs):
+	print label, msecs, 'msec'
+
+def ints(n):
+	d = {}
+	for i in range(n):
+		d[i%100] = i
+		x = d[i%100]
+	return len(d)
+
+def tuples(n):
+	d = {}
+	for i in range(n):
+		d[(i%10, i%7)] = i
+		x = d[(i%10, i%7)]
+	return len(d)
+
+def strings(n):
+	d = {}
+	for i in range(n):
+		d[`i%100`] = i
+		x = d[`i%100`]
+	return len(d)
+
+def run(f, label, n):
+	t0 = time.millitimer()
+	dummy = f(n)
+	t1 = time.millitimer()
+	report(label, t1-t0)
+
+def main():
+	n = 100000
+	if len(sys.argv) > 1:
+		n = eval(sys.argv[1])
+	run(ints, 'int keys:', n)
+	run(tuples, 'tuple keys:', n)
+	run(strings, 'backquoted keys:', n)
+
+main()
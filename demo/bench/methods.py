@@ -0,0 +1,50 @@
+# Method call benchmark
+#
+# Calls methods on an instance of a class at the bottom of a five level
+# deep hierarchy: one defined in the class itself and one inherited from
+# the root, so that the cost of finding an attribute in the bases shows
+# up as the difference between the two; and the built-in append method
+# of a list.
+#
+# Usage: python methods.py [count]
+
+import sys, time
+
+class Level0():
+	def inherited(self): return 0
+	def inherited1(self, x): return x
+class Level1() = Level0(): pass
+class Level2() = Level1(): pass
+class Level3() = Level2(): pass
+class Level4() = Level3(): pass
+class Level5() = Level4():
+	def own(self): return 5
+	def own1(self, x): return x
+
+def report(label, msecs):
+	print label, msecs, 'msec'
+
+def main():
+	n = 100000
+	if len(sys.argv) > 1:
+		n = eval(sys.argv[1])
+	x = Level5()
+	t0 = time.millitimer()
+	for i in range(n):
+		dummy = x.own()
+		dummy = x.own1(i)
+	t1 = time.millitimer()
+	for i in range(n):
+		dummy = x.inherited()
+		dummy = x.inherited1(i)
+	t2 = time.millitimer()
+	l = []
+	for i in range(n):
+		l.append(i)
+		l.append(i)
+	t3 = time.millitimer()
+	report('own methods (' + `2*n` + ' calls):', t1-t0)
+	report('inherited methods (' + `2*n` + ' calls):', t2-t1)
+	report('list append (' + `2*n` + ' calls):', t3-t2)
+
+main()
@@ -0,0 +1,54 @@
+# Name lookup benchmark
+#
+# Times a loop that does little besides LOAD_NAME and STORE_NAME, so
+# the cost of dictionary lookups on variable names dominates.  The loop
+# runs at module level, where every name lives in a dictionary; the same
+# loop inside a function is timed as well, for comparison with local
+# variables.
+#
+# Usage: python names.py [count]
+
+import sys, time
+
+def report(label, msecs):
+	print label, msecs, 'msec'
+
+def run(n):
+	a = 1
+	b = 2
+	c = 3
+	for i in range(n):
+		x = a
+		x = b
+		x = c
+		x = a
+		x = b
+		x = c
+		x = len
+		x = None
+	return x
+
+n = 100000
+if len(sys.argv) > 1:
+	n = eval(sys.argv[1])
+
+a = 1
+b = 2
+c = 3
+t0 = time.millitimer()
+for i in range(n):
+	x = a
+	x = b
+	x = c
+	x = a
+	x = b
+	x = c
+	x = len
+	x = None
+t1 = time.millitimer()
+report('module names (' + `n` + ' iterations):', t1-t0)
+
+t0 = time.millitimer()
+x = run(n)
+t1 = time.millitimer()
+report('function names (' + `n` + ' iterations):', t1-t0)
@@ -0,0 +1,69 @@
+# Pipeline benchmark
+#
+# Converts a stream of numbers to strings, keeps those ending in a zero
+# and adds up their lengths, twice: once with every stage building a
+# list, once with every stage a generator.  For
+# each it reports the time taken and the peak number of arenas of the
+# small-object allocator: the generators should need no more memory for
+# a million numbers than for a thousand.
+#
+# Usage: python pipeline.py [count]
+
+import sys, time
+
+def report(label, msecs, arenas):
+	print label, msecs, 'msec,', arenas, 'arenas'
+
+# Stages building lists
+
+def numbers_list(n):
+	l = []
+	for i in range(n): l.append(i)
+	return l
+
+def strings_list(seq):
+	l = []
+	for x in seq: l.append(`x`)
+	return l
+
+def tens_list(seq):
+	l = []
+	for s in seq:
+		if s[-1:] = '0': l.append(s)
+	return l
+
+# The same stages as generators
+
+def numbers(n):
+	for i in range(n): yield i
+
+def strings(seq):
+	for x in seq: yield `x`
+
+def tens(seq):
+	for s in seq:
+		if s[-1:] = '0': yield s
+
+def total(seq):
+	n = 0
+	peak = sys.mallocstats()[0]
+	for s in seq:
+		n = n + len(s)
+		if s[-3:] = '000': peak = max(peak, sys.mallocstats()[0])
+	return n, peak
+
+def main():
+	n = 1000000
+	if len(sys.argv) > 1:
+		n = eval(sys.argv[1])
+	t0 = time.millitimer()
+	s1, peak = total(tens_list(strings_list(numbers_list(n))))
+	t1 = time.millitimer()
+	report('lists:', t1-t0, peak)
+	t0 = time.millitimer()
+	s2, peak = total(tens(strings(numbers(n))))
+	t1 = time.millitimer()
+	report('generators:', t1-t0, peak)
+	if s1 <> s2: print 'different results:', s1, s2
+
+main()
@@ -0,0 +1,122 @@
+# Interpreter benchmark suite
+#
+# Runs a set of small workloads in the style of lib/testall.py, each
+# exercising a different group of opcodes, and prints the time taken
+# by each and in total.  Compare the totals of two builds (e.g. with
+# and without computed goto dispatch) on the same machine.
+#
+# Usage: python pybench.py [rounds]
+
+import sys, time
+
+def arith(n):
+	x = 0
+	for i in range(n):
+		x = x + i*3 - i/2 + i%7
+		x = x - i*3
+	return x
+
+def compare(n):
+	k = 0
+	for i in range(n):
+		if i < 10 or i = 20: k = k+1
+		elif i > 30 and i <> 40: k = k-1
+		if not i: k = k+2
+	return k
+
+def f0(): return 1
+def f1(a): return a
+def f2(a, b): return a
+
+def calls(n):
+	for i in range(n):
+		dummy = f0()
+		dummy = f1(i)
+		dummy = f2(i, i)
+	return i
+
+def strings(n):
+	s = ''
+	for i in range(n):
+		t = 'abc' + `i`
+		s = t[1:] + s[:10]
+		u = s[2]
+	return len(s)
+
+def lists(n):
+	for i in range(n):
+		l = [1, 2, 3, 4]
+		l.append(i)
+		l[0] = l[1] + l[len(l)-1]
+		del l[2]
+		l = l + [i]
+		t = (i, l, 'x')
+		a, b, c = t
+	return len(l)
+
+def dicts(n):
+	d = {}
+	for i in range(n):
+		d['a'] = i
+		d['b'] = d['a']
+		if d.has_key('c'): pass
+		d['c'] = d['b']
+		del d['c']
+	return len(d)
+
+def tries(n):
+	k = 0
+	for i in range(n):
+		try:
+			if i%2: raise RuntimeError, 'x'
+			k = k+1
+		except RuntimeError:
+			k = k-1
+		try:
+			pass
+		finally:
+			k = k+1
+	return k
+
+class C():
+	def init(self, x):
+		self.x = x
+		return self
+	def get(self):
+		return self.x
+
+def classes(n):
+	for i in range(n):
+		c = C().init(i)
+		c.y = c.get()
+		y = c.x + c.y
+	return y
+
+def whiles(n):
+	i = 0
+	while i < n:
+		i = i+1
+	return i
+
+tests = [('arith', arith), ('compare', compare), ('calls', calls), \
+         ('strings', strings), ('lists', lists), ('dicts', dicts), \
+         ('tries', tries), ('classes', classes), ('whiles', whiles)]
+
+def main():
+	rounds = 3
+	if len(sys.argv) > 1:
+		rounds = eval(sys.argv[1])
+	n = 100000
+	total = 0
+	for name, func in tests:
+		best = 0
+		for r in range(rounds):
+			t0 = time.millitimer()
+			dummy = func(n)
+			t = time.millitimer() - t0
+			if r = 0 or t < best: best = t
+		print name + ':', best, 'msec'
+		total = total + best
+	print 'total:', total, 'msec'
+
+main()
@@ -40,6 +40,8 @@ def disassemble(co, lasti):
 				print '(' + co.co_names[oparg] + ')',
 			elif op in hasjrel:
 				print '(to ' + `i + oparg` + ')',
+			elif op in haslocal:
+				print '(' + co.co_varnames[oparg] + ')',
 		print
 
 def findlabels(code):
@@ -67,6 +69,7 @@ hasconst = []
 hasname = []
 hasjrel = []
 hasjabs = []
+haslocal = []
 
 opname = range(256)
 for op in opname: opname[op] = '<' + `op` + '>'
@@ -86,6 +89,10 @@ def jabs_op(name, op):
 	opname[op] = name
 	hasjabs.append(op)
 
+def local_op(name, op):
+	opname[op] = name
+	haslocal.append(op)
+
 # Instruction opcodes for compiled code
 
 def_op('STOP_CODE', 0)
@@ -94,6 +101,8 @@ def_op('ROT_TWO', 2)
 def_op('ROT_THREE', 3)
 def_op('DUP_TOP', 4)
 
+def_op('NOP', 9)
+
 def_op('UNARY_POSITIVE', 10)
 def_op('UNARY_NEGATIVE', 11)
 def_op('UNARY_NOT', 12)
@@ -107,6 +116,8 @@ def_op('BINARY_ADD', 23)
 def_op('BINARY_SUBTRACT', 24)
 def_op('BINARY_SUBSCR', 25)
 def_op('BINARY_CALL', 26)
+def_op('CALL_RANGE', 27)
+def_op('GET_ITER', 28)
 
 def_op('SLICE+0', 30)
 def_op('SLICE+1', 31)
@@ -130,6 +141,8 @@ def_op('PRINT_EXPR', 70)
 def_op('PRINT_ITEM', 71)
 def_op('PRINT_NEWLINE', 72)
 
+def_op('YIELD_VALUE', 79)
+
 def_op('BREAK_LOOP', 80)
 def_op('RAISE_EXCEPTION', 81)
 def_op('LOAD_LOCALS', 82)
@@ -150,6 +163,9 @@ def_op('UNPACK_LIST', 93)	# Number of list items
 # unused:		94
 name_op('STORE_ATTR', 95)	# Index in name list 
 name_op('DELETE_ATTR', 96)	# "" 
+name_op('LOAD_METHOD', 97)	# Index in name list
+def_op('CALL_METHOD', 98)	# Number of arguments
+def_op('CALL_FUNCTION', 99)	# Number of arguments, at least 2
 
 def_op('LOAD_CONST', 100)	# Index in const list 
 hasconst.append(100)
@@ -168,9 +184,19 @@ jrel_op('JUMP_IF_TRUE', 112)	# ""
 jabs_op('JUMP_ABSOLUTE', 113)	# Target byte offset from beginning of code 
 jrel_op('FOR_LOOP', 114)	# Number of bytes to skip 
 
+name_op('LOAD_GLOBAL', 116)	# Index in name list
+
+name_op('LOAD_NAME_ATTR', 117)	# LOAD_NAME + LOAD_ATTR
+local_op('LOAD_FAST_ATTR', 118)	# LOAD_FAST + LOAD_ATTR
+def_op('COMPARE_JUMP_IF_FALSE', 119)	# COMPARE_OP + JUMP_IF_FALSE
+
 jrel_op('SETUP_LOOP', 120)	# Distance to target address
 jrel_op('SETUP_EXCEPT', 121)	# ""
 jrel_op('SETUP_FINALLY', 122)	# ""
 
+local_op('LOAD_FAST', 124)	# Local variable number
+local_op('STORE_FAST', 125)	# Local variable number
+local_op('DELETE_FAST', 126)	# Local variable number
+
 def_op('SET_LINENO', 127)	# Current line number
 SET_LINENO = 127
@@ -94,7 +94,7 @@ del x, y, (z, xyz)
 print 'pass_stmt' # 'pass' NEWLINE
 pass
 
-print 'flow_stmt' # break_stmt | return_stmt | raise_stmt
+print 'flow_stmt' # break_stmt | return_stmt | yield_stmt | raise_stmt
 # Tested below
 
 print 'break_stmt' # 'break' NEWLINE
@@ -106,6 +106,12 @@ def g2(): return 1
 g1()
 x = g2()
 
+print 'yield_stmt' # 'yield' testlist NEWLINE
+def g1(): yield 1
+def g2(): yield 1, 2
+x = g1()
+x = g2()
+
 print 'raise_stmt' # 'raise' expr [',' expr] NEWLINE
 try: raise RuntimeError, 'just testing'
 except RuntimeError: pass
@@ -282,6 +288,176 @@ for i in range(10):
 if n <> 90:
 	raise TestFailed, 'try inside for'
 
+print '2.2 local variables in functions'
+x = 'global'
+def f(a, (b, c)):
+	if x <> 'global': raise TestFailed, 'unassigned local sees global'
+	x = a+b+c
+	if x <> 6: raise TestFailed, 'local assignment'
+	del x
+	if x <> 'global': raise TestFailed, 'deleted local sees global'
+	exec('x = 7\n')
+	if x <> 7: raise TestFailed, 'exec assigns local'
+	if dir() <> ['a', 'b', 'c', 'x']: raise TestFailed, 'dir() in function'
+f(1, (2, 3))
+if x <> 'global': raise TestFailed, 'local leaked into globals'
+def f():
+	from sys import modules
+	return modules
+if f() <> sys.modules: raise TestFailed, 'from import in function'
+def f():
+	exec('def g(): return 5\nimport sys\n')
+	return g() + len(sys.argv)
+if f() <> 5 + len(sys.argv): raise TestFailed, 'names bound by exec in function'
+
+print '2.3 cached global and builtin names'
+def f(): return len('abc')
+for i in range(3):
+	if f() <> 3: raise TestFailed, 'builtin through cache'
+def len(x): return 'shadowed'
+if f() <> 'shadowed': raise TestFailed, 'global shadowing builtin'
+del len
+if f() <> 3: raise TestFailed, 'builtin after deleting global'
+y = 1
+for i in range(3):
+	if y <> i+1: raise TestFailed, 'rebound global at module level'
+	y = y+1
+def g(): return y
+if g() <> 4: raise TestFailed, 'rebound global in function'
+
+print '2.4 method calls'
+class C():
+	def none(self): return self
+	def one(self, a): return a
+	def two(self, (a, b)): return a - b
+	def whole(args): return args
+x = C()
+if x.none() is not x: raise TestFailed, 'method without argument'
+if x.one(1) <> 1 or x.one((1, 2)) <> (1, 2): raise TestFailed, 'one argument'
+if x.two(3, 1) <> 2: raise TestFailed, 'two arguments'
+if x.whole(1, 2) <> (x, (1, 2)): raise TestFailed, 'unpacked by callee'
+m = x.one
+if m(5) <> 5: raise TestFailed, 'class method object'
+x.one = len
+if x.one('abc') <> 3: raise TestFailed, 'member shadowing method'
+del x.one
+if x.one(3) <> 3: raise TestFailed, 'method after deleting member'
+try:
+	dummy = x.nonexistent()
+	raise TestFailed, 'undefined method'
+except NameError:
+	pass
+try:
+	dummy = x.two(1)
+	raise TestFailed, 'wrong number of arguments'
+except TypeError:
+	pass
+l = []
+l.append(1)
+if l <> [1] or sys.modules.has_key('nonexistent'): raise TestFailed, 'builtin methods'
+m = l.append
+m(2)
+d = {}
+d['a'] = 1
+if l <> [1, 2] or d.keys() <> ['a']: raise TestFailed, 'builtin method objects'
+try:
+	l.nonexistent(1)
+	raise TestFailed, 'undefined builtin method'
+except NameError:
+	pass
+if 'len' not in f.func_code.co_names: raise TestFailed, 'data members'
+try:
+	dummy = f.func_code.nonexistent
+	raise TestFailed, 'undefined data member'
+except NameError:
+	pass
+
+print '2.5 inherited attributes'
+class A():
+	def f(self): return 'A.f'
+	def g(self): return 'A.g'
+class B() = A():
+	def g(self): return 'B.g'
+class C() = A():
+	def f(self): return 'C.f'
+	def h(self): return 'C.h'
+class D() = B(), C(): pass
+class E() = D(): pass
+x = E()
+for i in range(3):
+	if x.f() <> 'A.f' or x.g() <> 'B.g' or x.h() <> 'C.h':
+		raise TestFailed, 'depth first lookup'
+if C().f() <> 'C.f' or B().f() <> 'A.f': raise TestFailed, 'lookup in bases'
+for i in range(2):
+	try:
+		dummy = x.nonexistent
+		raise TestFailed, 'undefined inherited attribute'
+	except NameError:
+		pass
+
+print '2.6 argument passing'
+def f(a, b, c): return a*100 + b*10 + c
+if f(1, 2, 3) <> 123: raise TestFailed, 'arguments into locals'
+if f((1, 2, 3)) <> 123: raise TestFailed, 'tuple as arguments'
+if f(f(0, 0, 1), 2, f(0, 0, 3)) <> 123: raise TestFailed, 'nested calls'
+def f(args): return args
+if f(1, 2) <> (1, 2): raise TestFailed, 'arguments as one tuple'
+def f(a, (b, c)): return a + b*c
+if f(1, (2, 3)) <> 7: raise TestFailed, 'nested parameters'
+def f(a, b):
+	a = a + b
+	return a
+x = 1
+if f(x, 2) <> 3 or x <> 1: raise TestFailed, 'argument rebound by callee'
+try:
+	dummy = f(1, 2, 3)
+	raise TestFailed, 'too many arguments'
+except RuntimeError:
+	pass
+class C():
+	def three(self, (a, b, c)): return a*100 + b*10 + c
+x = C()
+m = x.three
+if x.three(1, 2, 3) <> 123 or m(1, 2, 3) <> 123:
+	raise TestFailed, 'method arguments into locals'
+l = [1, 3]
+l.insert(1, 2)
+m = l.insert
+m(0, 0)
+if l <> [0, 1, 2, 3]: raise TestFailed, 'arguments to built-in method'
+if divmod((7, 2)) <> (3, 1) or max((5,)) <> 5:
+	raise TestFailed, 'tuple argument to built-in function'
+
+print '2.7 recursion'
+def f(n):
+	if n = 0: return 0
+	return f(n-1) + 1
+if f(5000) <> 5000: raise TestFailed, 'deep recursion'
+limit = sys.getrecursionlimit()
+sys.setrecursionlimit(100)
+try:
+	dummy = f(200)
+	raise TestFailed, 'recursion limit'
+except RuntimeError:
+	pass
+if f(50) <> 50: raise TestFailed, 'after recursion limit'
+sys.setrecursionlimit(limit)
+def f(n):
+	if n = 0: raise NameError, 'deep'
+	try:
+		return f(n-1)
+	finally:
+		n = -1
+try:
+	dummy = f(10)
+	raise TestFailed, 'exception through calls'
+except NameError:
+	pass
+def f(n):
+	if n = 0: return eval('0')
+	return eval('f(' + `n-1` + ')') + 1
+if f(20) <> 20: raise TestFailed, 'calls through eval()'
+
 
 #########################################################
 # Part 3.  Test all operations on all object types
@@ -290,6 +466,266 @@ if n <> 90:
 print '3. Object types'
 print 'XXX Not yet implemented'
 
+print '3.1 list growth and shrinking'
+a = []
+for i in range(1000): a.append(i)
+for i in range(1000):
+	if a[i] <> i: raise TestFailed, 'list append'
+a.insert(0, -1)
+a.insert(500, 'x')
+if len(a) <> 1002 or a[0] <> -1 or a[500] <> 'x' or a[1001] <> 999:
+	raise TestFailed, 'list insert'
+del a[1:1001]
+if a <> [-1, 999]: raise TestFailed, 'list slice deletion'
+a[1:1] = range(100)
+if len(a) <> 102 or a[1] <> 0 or a[101] <> 999:
+	raise TestFailed, 'list slice insertion'
+while a: del a[0]
+if a <> []: raise TestFailed, 'list emptied'
+a.append(1)
+if a <> [1]: raise TestFailed, 'list append after emptying'
+
+print '3.2 dictionary keys'
+d = {}
+d[1] = 'int'
+d[1.0] = 'float'
+d['1'] = 'string'
+d[(1, 'a')] = 'tuple'
+d[()] = 'empty tuple'
+if len(d) <> 5: raise TestFailed, 'keys of different types'
+if d[1] <> 'int' or d[1.0] <> 'float' or d['1'] <> 'string':
+	raise TestFailed, 'int, float and string keys'
+if d[(1, 'a')] <> 'tuple' or d[()] <> 'empty tuple':
+	raise TestFailed, 'tuple keys'
+if not d.has_key((1, 'a')) or d.has_key((1, 'b')): raise TestFailed, 'has_key'
+d[-0.0] = 'zero'
+if d[0.0] <> 'zero': raise TestFailed, 'float zero keys'
+del d[1]
+if d.has_key(1) or len(d) <> 5: raise TestFailed, 'del of int key'
+x = 1e300*1e300
+d[x] = 'inf'
+d[-x] = '-inf'
+d[x-x] = 'nan'
+if d[x] <> 'inf' or d[-x] <> '-inf': raise TestFailed, 'infinite float keys'
+for i in range(1000): d[i] = i*i
+for i in range(1000):
+	if d[i] <> i*i: raise TestFailed, 'many int keys'
+try:
+	d[[]] = 1
+	raise TestFailed, 'list as key'
+except TypeError:
+	pass
+try:
+	d[(1, [])] = 1
+	raise TestFailed, 'tuple with list as key'
+except TypeError:
+	pass
+d = {}
+for i in range(100):
+	d['k' + `i`] = i
+	if i >= 10: del d['k' + `i-10`]
+for i in range(90): d['k' + `i`] = i
+if len(d) <> 100 or len(d.keys()) <> 100: raise TestFailed, 'delete and reinsert'
+for i in range(100):
+	if d['k' + `i`] <> i: raise TestFailed, 'values after deletes'
+d = {}
+for k in 'cab': d[k] = 0
+del d['a']
+d['a'] = 1
+if d.keys() <> ['c', 'b', 'a']: raise TestFailed, 'keys in insertion order'
+
+print '3.3 integers of all sizes'
+x = 1
+while 1:
+	try:
+		y = x*2
+	except:
+		break
+	x = y
+# Now x is the largest power of 2, which is not a tagged integer
+y = x/2
+if y+y <> x or x-y <> y or (x-1)+1 <> x: raise TestFailed, 'large sums'
+if not (y < x and x > y and x-1 < x and -x < -y): raise TestFailed, 'large compare'
+if x/2 <> y or x%y <> 0 or x/(x-1) <> 1: raise TestFailed, 'large division'
+if 100000*100000/100000 <> 100000 or -x*2 <> -x-x or -1*-y <> y: raise TestFailed, 'large products'
+for z in [(x, 2), (-x*2, -1), (-1, -x*2), (y+1, y-1)]:
+	try:
+		z = z[0]*z[1]
+		z = 'no overflow'
+	except:
+		z = 'overflow'
+	if z <> 'overflow': raise TestFailed, 'product overflow'
+d = {}
+d[x] = 1
+d[y] = 2
+if d[y+y] <> 1 or d[x/2] <> 2: raise TestFailed, 'large keys'
+if `x-1` <> `x/2*2-1` or int(float(y)) <> y: raise TestFailed, 'large conversions'
+l = [x, 1, y, 0]
+l.sort()
+if l <> [0, 1, y, x]: raise TestFailed, 'large sort'
+
+print '3.4 small-object allocation'
+import sys
+before = sys.mallocstats()
+if len(before) <> 7: raise TestFailed, 'mallocstats'
+l = []
+for i in range(30000):
+	l.append((i, `i`, [i]))
+during = sys.mallocstats()
+if during[0] <= before[0] or during[5] <= before[5]: raise TestFailed, 'arenas grow'
+if l[12345] <> (12345, '12345', [12345]): raise TestFailed, 'allocated objects'
+s = ''
+for i in range(100):
+	s = s + 'x'
+if len(s) <> 100 or s[99] <> 'x': raise TestFailed, 'growing string'
+l = None
+after = sys.mallocstats()
+if after[3] <= during[3] or after[0] >= during[0]: raise TestFailed, 'arenas released'
+
+print '3.5 free lists'
+l = []
+x = 0.0
+for i in range(100):
+	x = x + 1.0
+	l.append((x, i))
+l = None
+for i in range(100):
+	t = (i, i)
+	if t[0] <> i or t[1] <> i or len(t) <> 2: raise TestFailed, 'reused tuple'
+	x = 0.5 * 2.0
+	if x <> 1.0: raise TestFailed, 'reused float'
+if () <> () or len(()) <> 0 or (1, 2)[1:1] <> (): raise TestFailed, 'empty tuple'
+def f(n):
+	if n > 0: return f(n-1) + 1
+	return 0
+x = sys.clearfreelists()
+if f(1000) <> 1000: raise TestFailed, 'recursion with recycled frames'
+n = sys.clearfreelists()
+if n <= 0 or n > 500: raise TestFailed, 'bounded frame free list'
+if sys.clearfreelists() <> 0: raise TestFailed, 'clearfreelists twice'
+if (1, 2.5) <> (1, 2.5): raise TestFailed, 'after clearfreelists'
+
+print '3.6 for loops'
+def f(seq):
+	l = []
+	for x in seq: l.append(x)
+	return l
+if f([1, 2]) <> [1, 2] or f((1, 2)) <> [1, 2] or f('ab') <> ['a', 'b']:
+	raise TestFailed, 'loop over sequences'
+if f(xrange(3)) <> [0, 1, 2] or f(xrange(5, -5, -3)) <> [5, 2, -1, -4]:
+	raise TestFailed, 'loop over xrange'
+l = []
+for i in range(4):
+	for j in range(i, 3):
+		if j = 2: break
+		l.append((i, j))
+	else:
+		l.append(i)
+if l <> [(0, 0), (0, 1), (1, 1), 3]: raise TestFailed, 'nested range loops'
+def range(n): return ['shadowed']
+l = []
+for i in range(3): l.append(i)
+del range
+if l <> ['shadowed']: raise TestFailed, 'shadowed range'
+try:
+	for i in range(1, 2, 0): pass
+	raise TestFailed, 'zero step'
+except RuntimeError:
+	pass
+d = {}
+d['a'] = 1
+d['b'] = 2
+d[3] = 4
+if f(d) <> ['a', 'b', 3]: raise TestFailed, 'loop over dictionary'
+try:
+	for k in d: d[`k` + 'x'] = 0
+	raise TestFailed, 'dictionary changed in loop'
+except RuntimeError:
+	pass
+l = [1, 2]
+m = []
+for x in l:
+	m.append(x)
+	if x < 3: l.append(x + 2)
+if m <> [1, 2, 3, 4]: raise TestFailed, 'list changed in loop'
+try:
+	for x in 1: pass
+	raise TestFailed, 'loop over int'
+except TypeError:
+	pass
+
+print '3.7 generators'
+def count(n):
+	i = 0
+	while i < n:
+		yield i
+		i = i + 1
+def squares(seq):
+	for x in seq: yield x*x
+def evens(seq):
+	for x in seq:
+		if x % 2 = 0: yield x
+l = []
+for x in evens(squares(count(7))): l.append(x)
+if l <> [0, 4, 16, 36]: raise TestFailed, 'generator pipeline'
+g = count(4)
+for x in g: break
+l = []
+for x in g: l.append(x)
+for x in g: l.append(x)
+if l <> [1, 2, 3]: raise TestFailed, 'resumed generator'
+def first(seq):
+	for x in seq: return x
+if first(count(10)) <> 0: raise TestFailed, 'dropped generator'
+def f(a, b):
+	yield a
+	return
+	yield b
+l = []
+for x in f(1, 2): l.append(x)
+if l <> [1]: raise TestFailed, 'return from generator'
+def f(n):
+	yield n
+	raise NameError, 'in generator'
+l = []
+try:
+	for x in f(5): l.append(x)
+	raise TestFailed, 'exception from generator'
+except NameError:
+	pass
+if l <> [5]: raise TestFailed, 'items before exception'
+def f(n):
+	if n > 0:
+		for x in f(n-1): yield x
+	yield n
+l = []
+for x in f(4): l.append(x)
+if l <> [0, 1, 2, 3, 4]: raise TestFailed, 'recursive generator'
+def f():
+	for x in g: yield x
+g = f()
+try:
+	for x in g: pass
+	raise TestFailed, 'generator running twice'
+except RuntimeError:
+	pass
+for s in ['yield 1\n', 'def f():\n\ttry: yield 1\n\tfinally: pass\n']:
+	try:
+		exec(s)
+		raise TestFailed, 'misplaced yield'
+	except TypeError:
+		pass
+
+print '3.8 repr of large objects'
+x = `[1, 'a\'\\\n', (2,), (), {}]`
+if x <> '[1, \'a\\\'\\\\\\012\', (2,), (), {}]': raise TestFailed, 'container repr'
+l = range(10000)
+x = `l`
+if len(x) <> 58890 or eval(x) <> l: raise TestFailed, 'large list repr'
+d = {}
+for i in range(1000): d[`i`] = (i,)
+if len(`d`) <> 14780: raise TestFailed, 'large dictionary repr'
+
 
 #########################################################
 # Part 4.  Test all built-in functions
@@ -371,6 +807,13 @@ if fp.read(300) <> 'XXX'*100: raise TestFailed, 'read(300)'
 if fp.read(1000) <> 'YYY'*100: raise TestFailed, 'read(1000) # truncate'
 fp.close()
 del fp
+fp = open('@test', 'r')
+l = []
+for line in fp: l.append(line)
+if len(l) <> 3 or l[1] <> 'Dear John\n' or l[2] <> 'XXX'*100 + 'YYY'*100:
+	raise TestFailed, 'loop over file'
+fp.close()
+del fp
 
 print 'range'
 if range(3) <> [0, 1, 2]: raise TestFailed, 'range(3)'
@@ -395,10 +838,40 @@ print 'reload'
 import string
 reload(string)
 
+print 'compiled module cache'
+fp = open('testcache.py', 'w')
+fp.write('i = 123456789\nn = -7\nf = 3.25\ns = \'a\\000b\'\nt = ()\n')
+fp.write('def g(x):\n\ty = x * 2\n\treturn y\n')
+fp.close()
+import testcache
+reload(testcache) # Now from testcache.pyc (or .pyo with -O)
+if testcache.i <> 123456789 or testcache.n <> -7 or testcache.f <> 3.25:
+	raise TestFailed, 'cached number constants'
+if len(testcache.s) <> 3 or testcache.s[2] <> 'b' or testcache.t <> ():
+	raise TestFailed, 'cached string constants'
+if testcache.g(21) <> 42: raise TestFailed, 'cached function'
+fp = open('testcache.py', 'w')
+fp.write('i = 7\n') # Likely within the same second as the .pyc
+fp.close()
+reload(testcache)
+if testcache.i <> 7: raise TestFailed, 'source rewritten after caching'
+
 print 'type'
 if type('') <> type('123') or type('') = type(()):
 	raise TestFailed, 'type()'
 
+print 'xrange'
+x = xrange(1, 10, 3)
+if len(x) <> 3 or x[0] <> 1 or x[2] <> 7 or x[1:] <> xrange(4, 10, 3):
+	raise TestFailed, 'xrange(1, 10, 3)'
+if `x` <> 'xrange(1, 10, 3)' or len(xrange(-3)) <> 0: raise TestFailed, 'xrange repr'
+if 7 not in x or 8 in x or xrange(3) <> xrange(0, 3): raise TestFailed, 'xrange compare'
+try:
+	dummy = x[3]
+	raise TestFailed, 'xrange index'
+except RuntimeError:
+	pass
+
 
 print 'Passed all tests.'
 
@@ -414,3 +887,7 @@ except NameError:
 
 unlink('@test')
 print 'Unlinked @test'
+unlink('testcache.py')
+for suffix in ['c', 'o']:
+	try: unlink('testcache.py' + suffix)
+	except: pass
@@ -0,0 +1,117 @@
+# Module 'testopt'
+#
+# Tests for the peephole optimizer; run as "python -O testopt.py".
+# Checks that the optimized code computes the same results as before,
+# and that the expected instructions were (or were not) generated.
+
+import dis
+
+TestFailed = 'testopt -- test failed'		# Exception
+
+def opnames(co):
+	code = co.co_code
+	names = []
+	n = len(code)
+	i = 0
+	while i < n:
+		op = ord(code[i])
+		names.append(dis.opname[op])
+		i = i+1
+		if op >= dis.HAVE_ARGUMENT: i = i+2
+	return names
+
+def has(f, name):
+	return name in opnames(f.func_code)
+
+print '1. Constant folding'
+
+def f(): return 2*3+4
+if f() <> 10: raise TestFailed, 'int folding value'
+if has(f, 'BINARY_ADD') or has(f, 'BINARY_MULTIPLY'):
+	raise TestFailed, 'int folding'
+if 10 not in f.func_code.co_consts: raise TestFailed, 'folded constant'
+
+def f(): return 'abc' + 'def'
+if f() <> 'abcdef': raise TestFailed, 'string folding value'
+if has(f, 'BINARY_ADD'): raise TestFailed, 'string folding'
+
+def f(): return -(1.5*2.0)
+if f() <> -3.0: raise TestFailed, 'float folding value'
+if has(f, 'UNARY_NEGATIVE'): raise TestFailed, 'negation folding'
+
+def f(): return 7/0
+try:
+	dummy = f()
+	raise TestFailed, 'division by zero folded'
+except TestFailed:
+	raise TestFailed, 'division by zero folded'
+except:
+	pass
+if not has(f, 'BINARY_DIVIDE'): raise TestFailed, 'error folded'
+
+def f(): return 'abc' * 2
+if f() <> 'abcabc': raise TestFailed, 'string repeat value'
+
+print '2. Superinstructions'
+
+def f(a): return a.co_code
+if f(f.func_code) <> f.func_code.co_code: raise TestFailed, 'LOAD_FAST_ATTR'
+if not has(f, 'LOAD_FAST_ATTR'): raise TestFailed, 'no LOAD_FAST_ATTR'
+
+def f(): return dis.opname
+if f() <> dis.opname: raise TestFailed, 'LOAD_GLOBAL + LOAD_ATTR'
+
+def f(a, b):
+	if a < b: return 1
+	return 0
+if f(1, 2) <> 1 or f(2, 1) <> 0: raise TestFailed, 'COMPARE_JUMP_IF_FALSE'
+if not has(f, 'COMPARE_JUMP_IF_FALSE'):
+	raise TestFailed, 'no COMPARE_JUMP_IF_FALSE'
+
+print '3. Jumps'
+
+def f(n):
+	x = 0
+	while n > 0:
+		if n % 2 = 0:
+			x = x + n
+		n = n - 1
+	return x
+if f(10) <> 30: raise TestFailed, 'nested loop'
+
+def f(x):
+	for i in range(5):
+		try:
+			if i = x: break
+		except RuntimeError:
+			pass
+	return i
+if f(3) <> 3: raise TestFailed, 'break from try'
+
+def f():
+	x = 1
+	y = 2
+	return x+y
+if has(f, 'NOP'): raise TestFailed, 'NOP left in code'
+
+def f(n):
+	x = 0
+	for i in range(n): x = x + i
+	return x
+if f(5) <> 10: raise TestFailed, 'loop over range'
+if not has(f, 'CALL_RANGE') or has(f, 'BINARY_CALL'):
+	raise TestFailed, 'no CALL_RANGE'
+
+def f(a, b): return a - b
+def g(x): return f(x, 1) + f(x, 2)
+if g(5) <> 7: raise TestFailed, 'call with arguments'
+if not has(g, 'CALL_FUNCTION') or has(g, 'BUILD_TUPLE'):
+	raise TestFailed, 'arguments made into a tuple'
+
+print '4. Disassembly'
+
+def f(a, b):
+	if a.co_flags = b: return 2*3
+dis.disco(f.func_code)
+
+print 'Passed all tests.'
@@ -8,6 +8,7 @@
 #include "floatobject.h"
 #include "tupleobject.h"
 #include "listobject.h"
+#include "rangeobject.h"
 #include "dictobject.h"
 #include "methodobject.h"
 #include "moduleobject.h"
@@ -94,18 +95,14 @@ builtin_dir(object *self, object *v)
 }
 
 static object *
-builtin_divmod(object *self, object *v)
+builtin_divmod(object *self, object **args, int nargs)
 {
-	object *x, *y;
+	object *v, *x, *y;
 	long xi, yi, xdivy, xmody;
 
-	if (v == NULL || !is_tupleobject(v) || gettuplesize(v) != 2) {
-		err_setstr(TypeError, "divmod() requires 2 int arguments");
-		return NULL;
-	}
-	x = gettupleitem(v, 0);
-	y = gettupleitem(v, 1);
-	if (!is_intobject(x) || !is_intobject(y)) {
+	if (nargs != 2 || !is_intobject(x = args[0])
+        || !is_intobject(y = args[1]))
+    {
 		err_setstr(TypeError, "divmod() requires 2 int arguments");
 		return NULL;
 	}
@@ -166,7 +163,12 @@ exec_eval(object *v, int start)
                    "exec/eval arguments must be string[,dict[,dict]]");
 		return NULL;
 	}
-	return run_string(getstringvalue(str), start, globals, locals);
+	v = run_string(getstringvalue(str), start, globals, locals);
+	if (globals == NULL) {
+		/* Ran in our caller's locals; they may have changed */
+		mergelocals();
+    }
+	return v;
 }
 
 static object *
@@ -243,7 +245,7 @@ builtin_len(object *self, object *v)
 		err_setstr(TypeError, "len() without argument");
 		return NULL;
 	}
-	tp = v->ob_type;
+	tp = TYPEOF(v);
 	if (tp->tp_as_sequence != NULL) {
 		len = (*tp->tp_as_sequence->sq_length)(v);
 	}
@@ -258,17 +260,29 @@ builtin_len(object *self, object *v)
 }
 
 static object *
-min_max(object *v, int sign)
+min_max(object **args, int nargs, int sign)
 {
 	int i, n, cmp;
-	object *w, *x;
+	object *v, *w, *x;
 	sequence_methods *sq;
 
-	if (v == NULL) {
+	if (nargs == 0) {
 		err_setstr(TypeError, "min() or max() without argument");
 		return NULL;
 	}
-	sq = v->ob_type->tp_as_sequence;
+	if (nargs > 1) {
+		/* The arguments are the sequence */
+		w = args[0];
+		for (i = 1; i < nargs; i++) {
+			if (cmpobject(args[i], w) * sign > 0) {
+				w = args[i];
+            }
+		}
+		INCREF(w);
+		return w;
+	}
+	v = args[0];
+	sq = TYPEOF(v)->tp_as_sequence;
 	if (sq == NULL) {
 		err_setstr(TypeError, "min() or max() of non-sequence");
 		return NULL;
@@ -294,15 +308,15 @@ min_max(object *v, int sign)
 }
 
 static object *
-builtin_min(object *self, object *v)
+builtin_min(object *self, object **args, int nargs)
 {
-	return min_max(v, -1);
+	return min_max(args, nargs, -1);
 }
 
 static object *
-builtin_max(object *self, object *v)
+builtin_max(object *self, object **args, int nargs)
 {
-	return min_max(v, 1);
+	return min_max(args, nargs, 1);
 }
 
 static object *
@@ -336,74 +350,26 @@ builtin_ord(object *self, object *v)
 }
 
 static object *
-builtin_range(object *self, object *v)
+builtin_range(object *self, object **args, int nargs)
 {
-	static char *errmsg = "range() requires 1-3 int arguments";
-	int i, n;
-	long ilow, ihigh, istep;
+	object *v;
+	long ilow, istep;
+	int n;
 
-	if (v != NULL && is_intobject(v)) {
-		ilow = 0;
-        ihigh = getintvalue(v);
-        istep = 1;
-	}
-	else if (v == NULL || !is_tupleobject(v)) {
-		err_setstr(TypeError, errmsg);
+	if (getrangeargs(args, nargs, &ilow, &istep, &n) != 0) {
 		return NULL;
-	}
-	else {
-		n = gettuplesize(v);
-		if (n < 1 || n > 3) {
-			err_setstr(TypeError, errmsg);
-			return NULL;
-		}
-		for (i = 0; i < n; i++) {
-			if (!is_intobject(gettupleitem(v, i))) {
-				err_setstr(TypeError, errmsg);
-				return NULL;
-			}
-		}
-		if (n == 3) {
-			istep = getintvalue(gettupleitem(v, 2));
-			--n;
-		}
-		else {
-			istep = 1;
-        }
-		ihigh = getintvalue(gettupleitem(v, --n));
-		if (n > 0) {
-			ilow = getintvalue(gettupleitem(v, 0));
-        }
-		else {
-			ilow = 0;
-        }
-	}
-	if (istep == 0) {
-		err_setstr(RuntimeError, "zero step for range()");
-		return NULL;
-	}
-	/* XXX ought to check overflow of subtraction */
-	if (istep > 0) {
-		n = (ihigh - ilow + istep - 1) / istep;
-    }
-	else {
-		n = (ihigh - ilow + istep + 1) / istep;
-    }
-	if (n < 0) {
-		n = 0;
     }
 	v = newlistobject(n);
 	if (v == NULL) {
 		return NULL;
     }
-	for (i = 0; i < n; i++) {
-		object *w = newintobject(ilow);
+	for (int i = 0; i < n; i++) {
+		object *w = newintobject(ilow + i * istep);
 		if (w == NULL) {
 			DECREF(v);
 			return NULL;
 		}
 		setlistitem(v, i, w);
-		ilow += istep;
 	}
 	return v;
 }
@@ -451,30 +417,43 @@ builtin_type(object *self, object *v)
 		err_setstr(TypeError, "type() requres an argument");
 		return NULL;
 	}
-	v = (object *)v->ob_type;
+	v = (object *)TYPEOF(v);
 	INCREF(v);
 	return v;
 }
 
+static object *
+builtin_xrange(object *self, object **args, int nargs)
+{
+	long ilow, istep;
+	int n;
+
+	if (getrangeargs(args, nargs, &ilow, &istep, &n) != 0) {
+		return NULL;
+    }
+	return newrangeobject(ilow, istep, n);
+}
+
 static struct methodlist builtin_methods[] = {
 	{"abs", 		builtin_abs},
 	{"chr", 		builtin_chr},
 	{"dir", 		builtin_dir},
-	{"divmod", 		builtin_divmod},
+	{"divmod", 		(method)builtin_divmod, METH_FAST},
 	{"eval", 		builtin_eval},
 	{"exec", 		builtin_exec},
 	{"float", 		builtin_float},
 	{"input", 		builtin_input},
 	{"int",		    builtin_int},
 	{"len", 		builtin_len},
-	{"max", 		builtin_max},
-	{"min", 		builtin_min},
+	{"max", 		(method)builtin_max, METH_FAST},
+	{"min", 		(method)builtin_min, METH_FAST},
 	{"open", 		builtin_open}, /* XXX move to OS module */
 	{"ord", 		builtin_ord},
-	{"range", 		builtin_range},
+	{"range", 		(method)builtin_range, METH_FAST},
 	{"raw_input",	builtin_raw_input},
 	{"reload", 		builtin_reload},
 	{"type", 		builtin_type},
+	{"xrange", 		(method)builtin_xrange, METH_FAST},
 	{NULL, 			NULL},
 };
 
@@ -484,6 +463,18 @@ getbuiltin(char *name)
 	return dictlookup(builtin_dict, name);
 }
 
+object *
+getbuiltin2(object *name)
+{
+	return dict2lookup(builtin_dict, name);
+}
+
+object *
+getbuiltindict()
+{
+	return builtin_dict;
+}
+
 /* Predefined exceptions */
 object *RuntimeError;
 object *EOFError;
@@ -8,6 +8,8 @@ extern "C" {
 /* Built-in module interface */
 
 extern object *getbuiltin(char *);
+extern object *getbuiltin2(object *);
+extern object *getbuiltindict(void);
 extern void initbuiltin();
 
 #ifdef __cplusplus
@@ -2,16 +2,19 @@
 
 #include <stdio.h>
 
+#include "pyconfig.h"
 #include "object.h"
 #include "intobject.h"
 #include "floatobject.h"
 #include "tupleobject.h"
 #include "listobject.h"
+#include "rangeobject.h"
 #include "dictobject.h"
 #include "methodobject.h"
 #include "moduleobject.h"
 #include "funcobject.h"
 #include "classobject.h"
+#include "genobject.h"
 #include "errors.h"
 #include "malloc.h"
 #include "import.h"
@@ -39,6 +42,22 @@ prtrace(object *v, char *str)
 #endif
 
 static frameobject *current_frame;
+static object *range_function; /* The built-in range(), see CALL_RANGE */
+
+static frameobject *new_frame(codeobject *, object *, object *, object *,
+                              object *, object **, int);
+static object *eval_frame(frameobject *);
+
+static int ticker; /* Instructions or calls until the next interrupt check */
+
+/* Frames being run; calls fail once there are recursion_limit of them */
+static int recursion_depth;
+static int recursion_limit = 10000;
+
+/* Only eval_code() nests on the C stack (for eval(), exec(), import etc.),
+   each time for a main loop in eval_frame(); that is limited separately */
+#define MAXNESTING 4000
+static int nesting;
 
 object *
 getlocals()
@@ -47,10 +66,21 @@ getlocals()
 		return NULL;
     }
 	else {
+		fast2locals(current_frame);
 		return current_frame->f_locals;
     }
 }
 
+/* Copy changes made through the dictionary returned by getlocals() back
+   to the local variable slots of the current frame (used by exec()). */
+void
+mergelocals()
+{
+	if (current_frame != NULL) {
+		locals2fast(current_frame);
+    }
+}
+
 object *
 getglobals()
 {
@@ -62,6 +92,18 @@ getglobals()
     }
 }
 
+int
+getrecursionlimit()
+{
+	return recursion_limit;
+}
+
+void
+setrecursionlimit(int limit)
+{
+	recursion_limit = limit;
+}
+
 void
 printtraceback(FILE *fp)
 {
@@ -100,11 +142,11 @@ testbool(object *v)
 	if (is_floatobject(v)) {
 		return getfloatvalue(v) != 0.0;
     }
-	if (v->ob_type->tp_as_sequence != NULL) {
-		return (*v->ob_type->tp_as_sequence->sq_length)(v) != 0;
+	if (TYPEOF(v)->tp_as_sequence != NULL) {
+		return (*TYPEOF(v)->tp_as_sequence->sq_length)(v) != 0;
     }
-	if (v->ob_type->tp_as_mapping != NULL) {
-		return (*v->ob_type->tp_as_mapping->mp_length)(v) != 0;
+	if (TYPEOF(v)->tp_as_mapping != NULL) {
+		return (*TYPEOF(v)->tp_as_mapping->mp_length)(v) != 0;
     }
 	if (v == None) {
 		return 0;
@@ -116,11 +158,11 @@ testbool(object *v)
 static object *
 add(object *v, object *w)
 {
-	if (v->ob_type->tp_as_number != NULL) {
-		v = (*v->ob_type->tp_as_number->nb_add)(v, w);
+	if (TYPEOF(v)->tp_as_number != NULL) {
+		v = (*TYPEOF(v)->tp_as_number->nb_add)(v, w);
     }
-	else if (v->ob_type->tp_as_sequence != NULL) {
-		v = (*v->ob_type->tp_as_sequence->sq_concat)(v, w);
+	else if (TYPEOF(v)->tp_as_sequence != NULL) {
+		v = (*TYPEOF(v)->tp_as_sequence->sq_concat)(v, w);
     }
 	else {
 		err_setstr(TypeError, "+ not supported by operands");
@@ -132,8 +174,8 @@ add(object *v, object *w)
 static object *
 sub(object *v, object *w)
 {
-	if (v->ob_type->tp_as_number != NULL) {
-		return (*v->ob_type->tp_as_number->nb_subtract)(v, w);
+	if (TYPEOF(v)->tp_as_number != NULL) {
+		return (*TYPEOF(v)->tp_as_number->nb_subtract)(v, w);
     }
 	err_setstr(TypeError, "bad operand type(s) for -");
 	return NULL;
@@ -144,13 +186,13 @@ mul(object *v, object *w)
 {
 	typeobject *tp;
 
-	if (is_intobject(v) && w->ob_type->tp_as_sequence != NULL) {
+	if (is_intobject(v) && TYPEOF(w)->tp_as_sequence != NULL) {
 		/* int*sequence -- swap v and w */
 		object *tmp = v;
 		v = w;
 		w = tmp;
 	}
-	tp = v->ob_type;
+	tp = TYPEOF(v);
 	if (tp->tp_as_number != NULL) {
 		return (*tp->tp_as_number->nb_multiply)(v, w);
     }
@@ -172,8 +214,8 @@ mul(object *v, object *w)
 static object *
 divide(object *v, object *w)
 {
-	if (v->ob_type->tp_as_number != NULL) {
-		return (*v->ob_type->tp_as_number->nb_divide)(v, w);
+	if (TYPEOF(v)->tp_as_number != NULL) {
+		return (*TYPEOF(v)->tp_as_number->nb_divide)(v, w);
     }
 	err_setstr(TypeError, "bad operand type(s) for /");
 	return NULL;
@@ -182,8 +224,8 @@ divide(object *v, object *w)
 static object *
 rem(object *v, object *w)
 {
-	if (v->ob_type->tp_as_number != NULL) {
-		return (*v->ob_type->tp_as_number->nb_remainder)(v, w);
+	if (TYPEOF(v)->tp_as_number != NULL) {
+		return (*TYPEOF(v)->tp_as_number->nb_remainder)(v, w);
     }
 	err_setstr(TypeError, "bad operand type(s) for %");
 	return NULL;
@@ -192,8 +234,8 @@ rem(object *v, object *w)
 static object *
 neg(object *v)
 {
-	if (v->ob_type->tp_as_number != NULL) {
-		return (*v->ob_type->tp_as_number->nb_negative)(v);
+	if (TYPEOF(v)->tp_as_number != NULL) {
+		return (*TYPEOF(v)->tp_as_number->nb_negative)(v);
     }
 	err_setstr(TypeError, "bad operand type(s) for unary -");
 	return NULL;
@@ -202,8 +244,8 @@ neg(object *v)
 static object *
 pos(object *v)
 {
-	if (v->ob_type->tp_as_number != NULL) {
-		return (*v->ob_type->tp_as_number->nb_positive)(v);
+	if (TYPEOF(v)->tp_as_number != NULL) {
+		return (*TYPEOF(v)->tp_as_number->nb_positive)(v);
     }
 	err_setstr(TypeError, "bad operand type(s) for unary +");
 	return NULL;
@@ -220,15 +262,13 @@ not(object *v)
 }
 
 static object *
-call_builtin(object *func, object *arg)
+call_builtin(object *func, object **args, int nargs)
 {
 	if (is_methodobject(func)) {
-		method meth = getmethod(func);
-		object *self = getself(func);
-		return (*meth)(self, arg);
+		return fastcallmethod(func, getself(func), args, nargs);
 	}
 	if (is_classobject(func)) {
-		if (arg != NULL) {
+		if (nargs != 0) {
 			err_setstr(TypeError, "classobject() allows no arguments");
 			return NULL;
 		}
@@ -238,67 +278,182 @@ call_builtin(object *func, object *arg)
 	return NULL;
 }
 
-static object *
-call_function(object *func, object *arg)
+/* A method called with an argument gets the tuple (self, arg).  Nearly
+   always its code starts by unpacking that into two items, as in
+	   [SET_LINENO n] REQUIRE_ARGS UNPACK_TUPLE 2
+   so instead of building the tuple, new_frame() can push arg and self as
+   UNPACK_TUPLE would have left them and start after it.  Return the offset
+   of the first instruction after this prologue, or -1 if the code starts
+   differently. */
+static int
+method_prologue(codeobject *co)
 {
-	object *newarg = NULL;
-	object *newlocals, *newglobals;
-	object *co, *v;
-	
-	if (is_classmethodobject(func)) {
-		object *self = classmethodgetself(func);
-		func = classmethodgetfunc(func);
-		if (arg == NULL) {
-			arg = self;
-		}
-		else {
-			newarg = newtupleobject(2);
-			if (newarg == NULL) {
-				return NULL;
+	unsigned char *code = GETUSTRINGVALUE(co->co_code);
+	int n = getstringsize((object *)co->co_code), i = 0;
+
+	if (n >= 3 && code[0] == SET_LINENO) {
+		i = 3;
+	}
+	if (i + 4 > n || code[i] != REQUIRE_ARGS || code[i + 1] != UNPACK_TUPLE
+        || code[i + 2] != 2 || code[i + 3] != 0)
+    {
+		return -1;
+	}
+	return i + 4;
+}
+
+/* Better still, the arguments need not be pushed at all when the code goes
+   on to store each of them in a local variable, as that of a function or
+   method with plain parameters does:
+	   [SET_LINENO n] REQUIRE_ARGS [UNPACK_TUPLE 2] STORE_FAST self
+	   [UNPACK_TUPLE nargs] STORE_FAST a1 ... STORE_FAST anargs
+   The part for self is only there for a method, and its UNPACK_TUPLE only
+   if there are arguments; the UNPACK_TUPLE nargs only if nargs >= 2.
+   new_frame() then stores them itself, straight from the caller's stack.
+   Return the offset of the first instruction after this prologue, or -1 if
+   the code starts differently. */
+static int
+args_prologue(codeobject *co, int hasself, int nargs)
+{
+	unsigned char *code = GETUSTRINGVALUE(co->co_code);
+	int n = getstringsize((object *)co->co_code), i = 0;
+
+#define IS_INSTR(op, arg) \
+	(i + 3 <= n && code[i] == (op) \
+     && ((arg) < 0 || (code[i + 1] | (code[i + 2] << 8)) == (arg)))
+
+	if (n >= 3 && code[0] == SET_LINENO) {
+		i = 3;
+	}
+	if (i >= n || code[i++] != REQUIRE_ARGS) {
+		return -1;
+	}
+	if (hasself) {
+		if (nargs > 0) {
+			if (!IS_INSTR(UNPACK_TUPLE, 2)) {
+				return -1;
             }
-			INCREF(self);
-			INCREF(arg);
-			settupleitem(newarg, 0, self);
-			settupleitem(newarg, 1, arg);
-			arg = newarg;
+			i += 3;
 		}
+		if (!IS_INSTR(STORE_FAST, -1)) {
+			return -1;
+        }
+		i += 3;
 	}
-	else {
-		if (!is_funcobject(func)) {
-			err_setstr(TypeError, "call of non-function");
-			return NULL;
-		}
+	if (nargs >= 2) {
+		if (!IS_INSTR(UNPACK_TUPLE, nargs)) {
+			return -1;
+        }
+		i += 3;
 	}
-	
+	for (; nargs > 0; nargs--) {
+		if (!IS_INSTR(STORE_FAST, -1)) {
+			return -1;
+        }
+		i += 3;
+	}
+	return i;
+
+#undef IS_INSTR
+}
+
+/* Make the frame for a call of the function object func with the nargs
+   arguments in args: one argument is passed as it is, and two or more as a
+   tuple of them.  self is NULL or the object func is a method of.  The
+   arguments are only made into the objects the code expects if they can't
+   go straight into its locals (see args_prologue() and method_prologue()). */
+static frameobject *
+function_frame(object *func, object *self, object **args, int nargs)
+{
+	object *arg = NULL, *newarg = NULL;
+	object *newlocals;
+	object *co, *v;
+	frameobject *f;
+	int i, start;
+
 	co = getfunccode(func);
 	if (co == NULL) {
-		XDECREF(newarg);
 		return NULL;
-	}
+    }
 	if (!is_codeobject(co)) {
 		fprintf(stderr, "XXX Bad code\n");
 		abort();
 	}
-	newlocals = newdictobject();
-	if (newlocals == NULL) {
+	if (nargs == 0 && self == NULL) {
+		args = NULL;
+		start = 0;
+	}
+	else if ((start = args_prologue((codeobject *)co, self != NULL, nargs))
+             < 0)
+    {
+		if (nargs == 1) {
+			arg = args[0];
+        }
+		else if (nargs > 1) {
+			if ((arg = newarg = newtupleobject(nargs)) == NULL) {
+				return NULL;
+            }
+			for (i = 0; i < nargs; i++) {
+				INCREF(args[i]);
+				settupleitem(newarg, i, args[i]);
+			}
+		}
+		args = NULL;
+		start = 0;
+		if (self != NULL) {
+			if (arg == NULL) {
+				arg = self;
+				self = NULL;
+			}
+			else if ((start = method_prologue((codeobject *)co)) < 0) {
+				v = newtupleobject(2);
+				if (v == NULL) {
+					XDECREF(newarg);
+					return NULL;
+				}
+				INCREF(self);
+				INCREF(arg);
+				settupleitem(v, 0, self);
+				settupleitem(v, 1, arg);
+				XDECREF(newarg);
+				arg = newarg = v;
+				self = NULL;
+				start = 0;
+			}
+		}
+	}
+	/* Optimized code keeps its locals in the frame and needs no dict */
+	if (((codeobject *)co)->co_flags & CO_OPTIMIZED) {
+		newlocals = NULL;
+    }
+	else if ((newlocals = newdictobject()) == NULL) {
 		XDECREF(newarg);
 		return NULL;
 	}
 	
-	newglobals = getfuncglobals(func);
-	INCREF(newglobals);
-	v = eval_code((codeobject *)co, newglobals, newlocals, arg);
-	DECREF(newlocals);
-	DECREF(newglobals);
+	f = new_frame((codeobject *)co, getfuncglobals(func), newlocals, self,
+                  arg, args, start);
+	XDECREF(newlocals);
 	XDECREF(newarg);
 	
-	return v;
+	return f;
+}
+
+/* Make the frame for a call of a function or class method object */
+static frameobject *
+call_frame(object *func, object **args, int nargs)
+{
+	if (is_classmethodobject(func)) {
+		return function_frame(classmethodgetfunc(func),
+                              classmethodgetself(func), args, nargs);
+	}
+	return function_frame(func, (object *)NULL, args, nargs);
 }
 
 static object *
 apply_subscript(object *v, object *w)
 {
-	typeobject *tp = v->ob_type;
+	typeobject *tp = TYPEOF(v);
 
 	if (tp->tp_as_sequence == NULL && tp->tp_as_mapping == NULL) {
 		err_setstr(TypeError, "unsubscriptable object");
@@ -315,22 +470,72 @@ apply_subscript(object *v, object *w)
 	return (*tp->tp_as_mapping->mp_subscript)(v, w);
 }
 
+/* Look up local variable i of an optimized frame that has no value (yet):
+   like LOAD_NAME, fall back on the globals and builtins.  Returns a
+   borrowed reference, or NULL with NameError set. */
 static object *
-loop_subscript(object *v, object *w)
+unbound_local(frameobject *f, int i)
 {
-	sequence_methods *sq = v->ob_type->tp_as_sequence;
-	int i, n;
+	object *name = GETITEM(f->f_code->co_varnames, i);
+	object *x = dict2lookup(f->f_globals, name);
 
-	if (sq == NULL) {
-		err_setstr(TypeError, "loop over non-sequence");
-		return NULL;
+	if (x == NULL) {
+		x = getbuiltin2(name);
+    }
+	if (x == NULL) {
+		err_setstr(NameError, getstringvalue(name));
+    }
+	return x;
+}
+
+/* Look up name i of the code for LOAD_NAME (in the locals, the globals and
+   the builtins) or LOAD_GLOBAL (locals is NULL).  The result is kept in the
+   code's name cache along with the versions of the dictionaries, and is
+   reused for as long as none of them changes, which takes only a few
+   compares.  Returns a borrowed reference, or NULL with NameError set. */
+static object *
+load_name(codeobject *co, int i, object *locals, object *globals)
+{
+	object *builtins = getbuiltindict();
+	object *name, *x;
+	namecache *nc;
+	int n;
+
+	if ((nc = co->co_namecache) == NULL) {
+		n = getlistsize(co->co_names);
+		if ((nc = co->co_namecache = NEW(namecache, n)) != NULL) {
+			while (--n >= 0) {
+				nc[n].nc_globals = 0; /* Never a valid version */
+            }
+		}
+	}
+	if (nc != NULL) {
+		nc += i;
+		if (nc->nc_globals == GETDICTVERSION(globals)
+            && nc->nc_builtins == GETDICTVERSION(builtins)
+            && nc->nc_locals == (locals ? GETDICTVERSION(locals) : 0))
+        {
+			return nc->nc_value;
+        }
 	}
-	i = getintvalue(w);
-	n = (*sq->sq_length)(v);
-	if (i >= n) {
-		return NULL; /* End of loop */
+	name = GETITEM(co->co_names, i);
+	x = NULL;
+	if (locals != NULL) {
+		x = dict2lookup(locals, name);
     }
-	return (*sq->sq_item)(v, i);
+	if (x == NULL && (x = dict2lookup(globals, name)) == NULL
+        && (x = dict2lookup(builtins, name)) == NULL)
+    {
+		err_setstr(NameError, getstringvalue(name));
+		return NULL;
+	}
+	if (nc != NULL) {
+		nc->nc_value = x;
+		nc->nc_locals = locals ? GETDICTVERSION(locals) : 0;
+		nc->nc_globals = GETDICTVERSION(globals);
+		nc->nc_builtins = GETDICTVERSION(builtins);
+	}
+	return x;
 }
 
 static int
@@ -353,7 +558,7 @@ slice_index(object *v, int isize, int *pi)
 static object *
 apply_slice(object *u, object *v, object *w)
 {
-	typeobject *tp = u->ob_type;
+	typeobject *tp = TYPEOF(u);
 	int ilow, ihigh, isize;
 
 	if (tp->tp_as_sequence == NULL) {
@@ -375,7 +580,7 @@ apply_slice(object *u, object *v, object *w)
 static int
 assign_subscript(object *w, object *key, object *v)
 {
-	typeobject *tp = w->ob_type;
+	typeobject *tp = TYPEOF(w);
 	sequence_methods *sq;
 	mapping_methods *mp;
 	int (*func_seq)(object *, int, object *);
@@ -407,7 +612,7 @@ assign_subscript(object *w, object *key, object *v)
 static int
 assign_slice(object *u, object *v, object *w, object *x)
 {
-	sequence_methods *sq = u->ob_type->tp_as_sequence;
+	sequence_methods *sq = TYPEOF(u)->tp_as_sequence;
 	int ilow, ihigh, isize;
 
 	if (sq == NULL) {
@@ -468,7 +673,7 @@ cmp_member(object *v, object *w)
 		}
 		return 0;
 	}
-	sq = w->ob_type->tp_as_sequence;
+	sq = TYPEOF(w)->tp_as_sequence;
 	if (sq == NULL) {
 		err_setstr(TypeError,
 			       "'in' or 'not in' needs sequence right argument");
@@ -486,6 +691,44 @@ cmp_member(object *v, object *w)
 	return 0;
 }
 
+/* Compare two tagged integers: since the tag keeps the order of the values,
+   the pointers themselves can be compared */
+static object *
+cmp_tagged(enum cmp_op op, object *v, object *w)
+{
+	register long a = (long)v, b = (long)w;
+	register int res;
+
+	switch (op) {
+		case LT:
+			res = a < b;
+			break;
+
+		case LE:
+			res = a <= b;
+			break;
+
+		case EQ:
+			res = a == b;
+			break;
+
+		case NE:
+			res = a != b;
+			break;
+
+		case GT:
+			res = a > b;
+			break;
+
+		default:
+			res = a >= b;
+			break;
+	}
+	v = res ? True : False;
+	INCREF(v);
+	return v;
+}
+
 static object *
 cmp_outcome(enum cmp_op op, register object *v, register object *w)
 {
@@ -613,12 +856,123 @@ enum why_code {
 	WHY_EXCEPTION,	/* Exception occurred */
 	WHY_RERAISE,	/* Exception re-raised by 'finally' */
 	WHY_RETURN,		/* 'return' statement */
-	WHY_BREAK		/* 'break' statement */
+	WHY_BREAK,		/* 'break' statement */
+	WHY_YIELD		/* 'yield' statement */
 };
 
-/* Interpreter main loop */
 object *
 eval_code(codeobject *co, object *globals, object *locals, object *arg)
+{
+	frameobject *f;
+	object *v;
+
+	if (nesting >= MAXNESTING) {
+		err_setstr(RuntimeError, "maximum recursion depth exceeded");
+		return NULL;
+	}
+	f = new_frame(co, globals, locals, (object *)NULL, arg, (object **)NULL,
+                  0);
+	if (f == NULL) {
+		return NULL;
+    }
+	nesting++;
+	v = eval_frame(f);
+	nesting--;
+	return v;
+}
+
+/* Run the frame f of a generator (see genobject.c) from where it was
+   suspended, as if called from the current frame, until it yields a value
+   or ends.  When it has ended, its f_stacktop is NULL. */
+object *
+resume_frame(frameobject *f)
+{
+	object *v;
+
+	if (nesting >= MAXNESTING || recursion_depth >= recursion_limit) {
+		err_setstr(RuntimeError, "maximum recursion depth exceeded");
+		return NULL;
+	}
+	XINCREF(current_frame);
+	f->f_back = current_frame;
+	INCREF(f); /* Released by eval_frame() */
+	recursion_depth++;
+	nesting++;
+	v = eval_frame(f);
+	nesting--;
+	XDECREF(f->f_back);
+	f->f_back = NULL;
+	return v;
+}
+
+/* Make a frame to run code object co in, and count it as being run.
+   Execution is to start at offset start, after a prologue of the code that
+   handles the arguments (see function_frame()): if args is NULL, arg and
+   then self are pushed as the prologue would have left them, each unless it
+   is NULL; otherwise self, unless it is NULL, and the items of args are
+   stored where its STORE_FAST instructions would have put them. */
+static frameobject *
+new_frame(codeobject *co, object *globals, object *locals, object *self,
+          object *arg, object **args, int start)
+{
+	unsigned char *code = GETUSTRINGVALUE(co->co_code);
+	frameobject *f;
+	object *v, *w;
+	int i, oparg;
+
+	if (recursion_depth >= recursion_limit) {
+		err_setstr(RuntimeError, "maximum recursion depth exceeded");
+		return NULL;
+	}
+	f = newframeobject(
+		current_frame,		/*back*/
+		co,					/*code*/
+		globals,			/*globals*/
+		locals,				/*locals*/
+		co->co_stacksize,	/*nvalues*/
+		co->co_maxblocks	/*nblocks*/
+    );
+	if (f == NULL) {
+		return NULL;
+    }
+	if (start > 0 && code[0] == SET_LINENO) {
+		f->f_lineno = code[1] | (code[2] << 8);
+    }
+	if (args != NULL) {
+		for (i = 0; i < start; i += HAS_ARG(code[i]) ? 3 : 1) {
+			if (code[i] == STORE_FAST) {
+				v = self != NULL ? self : *args++;
+				self = NULL;
+				INCREF(v);
+				oparg = code[i + 1] | (code[i + 2] << 8);
+				w = f->f_fastlocals[oparg];
+				f->f_fastlocals[oparg] = v;
+				XDECREF(w);
+			}
+		}
+	}
+	else {
+		if (arg != NULL) {
+			INCREF(arg);
+			*f->f_stacktop++ = arg;
+		}
+		if (self != NULL) {
+			INCREF(self);
+			*f->f_stacktop++ = self;
+		}
+	}
+	f->f_lasti = start;
+	recursion_depth++;
+	return f;
+}
+
+/* Interpreter main loop: run frame f, made by new_frame(), and release it.
+   A call of a Python function doesn't recursively call eval_frame(): its
+   frame is run in this same loop, and the calling frame waits in the call
+   instruction, with its state saved in f_stacktop, f_lasti and f_lineno,
+   until the loop returns to it. */
+static object *
+eval_frame(frameobject *f)
 {
 	register unsigned char *next_instr;
 	register int opcode;		/* Current opcode */
@@ -629,18 +983,98 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 	register object *x;			/* Result object -- NULL if error */
 	register object *v;			/* Temporary objects popped off stack */
 	register object *w, *u, *t;
-	register frameobject *f; 	/* Current frame */
+	frameobject *entry = f;		/* Frame to return from */
+	frameobject *newf;			/* Frame of a function being called */
+#ifdef USE_COMPUTED_GOTOS
+	/* Dispatch table for computed gotos; see TARGET() below */
+	static void *opcode_targets[256] = {
+		[0 ... 255] = &&_unknown_opcode,
+		[POP_TOP] = &&TARGET_POP_TOP,
+		[ROT_TWO] = &&TARGET_ROT_TWO,
+		[ROT_THREE] = &&TARGET_ROT_THREE,
+		[DUP_TOP] = &&TARGET_DUP_TOP,
+		[UNARY_POSITIVE] = &&TARGET_UNARY_POSITIVE,
+		[UNARY_NEGATIVE] = &&TARGET_UNARY_NEGATIVE,
+		[UNARY_NOT] = &&TARGET_UNARY_NOT,
+		[UNARY_CONVERT] = &&TARGET_UNARY_CONVERT,
+		[UNARY_CALL] = &&TARGET_UNARY_CALL,
+		[BINARY_MULTIPLY] = &&TARGET_BINARY_MULTIPLY,
+		[BINARY_DIVIDE] = &&TARGET_BINARY_DIVIDE,
+		[BINARY_MODULO] = &&TARGET_BINARY_MODULO,
+		[BINARY_ADD] = &&TARGET_BINARY_ADD,
+		[BINARY_SUBTRACT] = &&TARGET_BINARY_SUBTRACT,
+		[BINARY_SUBSCR] = &&TARGET_BINARY_SUBSCR,
+		[BINARY_CALL] = &&TARGET_BINARY_CALL,
+		[CALL_FUNCTION] = &&TARGET_CALL_FUNCTION,
+		[CALL_RANGE] = &&TARGET_CALL_RANGE,
+		[GET_ITER] = &&TARGET_GET_ITER,
+		[SLICE ... SLICE + 3] = &&TARGET_SLICE,
+		[STORE_SLICE ... STORE_SLICE + 3] = &&TARGET_STORE_SLICE,
+		[DELETE_SLICE ... DELETE_SLICE + 3] = &&TARGET_DELETE_SLICE,
+		[STORE_SUBSCR] = &&TARGET_STORE_SUBSCR,
+		[DELETE_SUBSCR] = &&TARGET_DELETE_SUBSCR,
+		[PRINT_EXPR] = &&TARGET_PRINT_EXPR,
+		[PRINT_ITEM] = &&TARGET_PRINT_ITEM,
+		[PRINT_NEWLINE] = &&TARGET_PRINT_NEWLINE,
+		[BREAK_LOOP] = &&TARGET_BREAK_LOOP,
+		[RAISE_EXCEPTION] = &&TARGET_RAISE_EXCEPTION,
+		[LOAD_LOCALS] = &&TARGET_LOAD_LOCALS,
+		[RETURN_VALUE] = &&TARGET_RETURN_VALUE,
+		[YIELD_VALUE] = &&TARGET_YIELD_VALUE,
+		[REQUIRE_ARGS] = &&TARGET_REQUIRE_ARGS,
+		[REFUSE_ARGS] = &&TARGET_REFUSE_ARGS,
+		[BUILD_FUNCTION] = &&TARGET_BUILD_FUNCTION,
+		[POP_BLOCK] = &&TARGET_POP_BLOCK,
+		[END_FINALLY] = &&TARGET_END_FINALLY,
+		[BUILD_CLASS] = &&TARGET_BUILD_CLASS,
+		[STORE_NAME] = &&TARGET_STORE_NAME,
+		[DELETE_NAME] = &&TARGET_DELETE_NAME,
+		[UNPACK_TUPLE] = &&TARGET_UNPACK_TUPLE,
+		[UNPACK_LIST] = &&TARGET_UNPACK_LIST,
+		[STORE_ATTR] = &&TARGET_STORE_ATTR,
+		[DELETE_ATTR] = &&TARGET_DELETE_ATTR,
+		[LOAD_METHOD] = &&TARGET_LOAD_METHOD,
+		[CALL_METHOD] = &&TARGET_CALL_METHOD,
+		[LOAD_CONST] = &&TARGET_LOAD_CONST,
+		[LOAD_NAME] = &&TARGET_LOAD_NAME,
+		[LOAD_GLOBAL] = &&TARGET_LOAD_GLOBAL,
+		[LOAD_FAST] = &&TARGET_LOAD_FAST,
+		[LOAD_NAME_ATTR] = &&TARGET_LOAD_NAME_ATTR,
+		[LOAD_FAST_ATTR] = &&TARGET_LOAD_FAST_ATTR,
+		[COMPARE_JUMP_IF_FALSE] = &&TARGET_COMPARE_JUMP_IF_FALSE,
+		[NOP] = &&TARGET_NOP,
+		[STORE_FAST] = &&TARGET_STORE_FAST,
+		[DELETE_FAST] = &&TARGET_DELETE_FAST,
+		[BUILD_TUPLE] = &&TARGET_BUILD_TUPLE,
+		[BUILD_LIST] = &&TARGET_BUILD_LIST,
+		[BUILD_MAP] = &&TARGET_BUILD_MAP,
+		[LOAD_ATTR] = &&TARGET_LOAD_ATTR,
+		[COMPARE_OP] = &&TARGET_COMPARE_OP,
+		[IMPORT_NAME] = &&TARGET_IMPORT_NAME,
+		[IMPORT_FROM] = &&TARGET_IMPORT_FROM,
+		[JUMP_FORWARD] = &&TARGET_JUMP_FORWARD,
+		[JUMP_IF_FALSE] = &&TARGET_JUMP_IF_FALSE,
+		[JUMP_IF_TRUE] = &&TARGET_JUMP_IF_TRUE,
+		[JUMP_ABSOLUTE] = &&TARGET_JUMP_ABSOLUTE,
+		[FOR_LOOP] = &&TARGET_FOR_LOOP,
+		[SETUP_LOOP] = &&TARGET_SETUP_LOOP,
+		[SETUP_EXCEPT] = &&TARGET_SETUP_LOOP,
+		[SETUP_FINALLY] = &&TARGET_SETUP_LOOP,
+		[SET_LINENO] = &&TARGET_SET_LINENO,
+	};
+#endif
 	int lineno;					/* Current line number */
-	object *retval;				/* Return value iff why == WHY_RETURN */
+	object *retval;				/* Value iff why is WHY_RETURN or WHY_YIELD */
 	char *name;					/* Name used by some instructions */
 	FILE *fp;					/* Used by print operations */
 #ifdef TRACE
-	int trace = dictlookup(globals, "__trace__") != NULL;
+	int trace = dictlookup(f->f_globals, "__trace__") != NULL;
 #endif
 
 /* Code access macros */
 #define GETCONST(i)		Getconst(f, i)
 #define GETNAME(i)		Getname(f, i)
+#define GETNAMEV(i)		(GETITEM(f->f_code->co_names, (i)))
 #define FIRST_INSTR()	(GETUSTRINGVALUE(f->f_code->co_code))
 #define INSTR_OFFSET()	(next_instr - FIRST_INSTR())
 #define NEXTOP()		(*next_instr++)
@@ -648,12 +1082,64 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 #define JUMPTO(x)		(next_instr = FIRST_INSTR() + (x))
 #define JUMPBY(x)		(next_instr += (x))
 
+/* Opcode dispatch macros.  With computed gotos, every handler ends by
+   jumping straight to the handler of the next instruction, decoding its
+   argument there; this gives the branch predictor one indirect jump per
+   handler instead of the single one in the switch.  A handler that may
+   fail ends with DISPATCH(), which first does the error test that the
+   code after the switch would do; a handler that cannot fail ends with
+   FAST_DISPATCH().  Without computed gotos these turn into 'break' and
+   'continue' of the switch and the main loop. */
+#ifdef USE_COMPUTED_GOTOS
+#define TARGET(op)			TARGET_##op: case op:
+#define TARGET_WITH_ARG(op)	TARGET_##op: oparg = NEXTARG(); case op:
+#ifdef TRACE
+#define FAST_DISPATCH() \
+	{ \
+		if (!trace) { \
+			opcode = NEXTOP(); \
+			goto *opcode_targets[opcode]; \
+		} \
+		continue; \
+	}
+#else
+#define FAST_DISPATCH() \
+	{ \
+		opcode = NEXTOP(); \
+		goto *opcode_targets[opcode]; \
+	}
+#endif
+#define DISPATCH() \
+	{ \
+		if (why == WHY_NOT && err == 0 && x != NULL) { \
+			FAST_DISPATCH(); \
+		} \
+		break; \
+	}
+#else
+#define TARGET(op)			case op:
+#define TARGET_WITH_ARG(op)	case op:
+#define FAST_DISPATCH()		continue
+#define DISPATCH()			break
+#endif
+
+/* Local variable macros */
+#define GETLOCAL(i)		(f->f_fastlocals[i])
+#define SETLOCAL(i, v)	(GETLOCAL(i) = (v))
+
 /* Stack manipulation macros */
 #define STACK_LEVEL()	(stack_pointer - f->f_valuestack)
 #define EMPTY()			(STACK_LEVEL() == 0)
 #define TOP()			(stack_pointer[-1])
-#define BASIC_PUSH(v)	(*stack_pointer++ = (v))
 #define BASIC_POP()		(*--stack_pointer)
+#ifdef NDEBUG
+#define BASIC_PUSH(v)	(*stack_pointer++ = (v))
+#else
+/* The frame is sized by the compiler's computed stack depth; check it */
+#define BASIC_PUSH(v) \
+	(STACK_LEVEL() < f->f_nvalues ? (void)(*stack_pointer++ = (v)) \
+                                  : fatal("value stack overflow"))
+#endif
 
 #ifdef TRACE
 #define PUSH(v)		(BASIC_PUSH(v), trace && prtrace(TOP(), "push"))
@@ -663,46 +1149,27 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 #define POP()		BASIC_POP()
 #endif
 
-	f = newframeobject(
-		current_frame,		/*back*/
-		co,					/*code*/
-		globals,			/*globals*/
-		locals,				/*locals*/
-		50,					/*nvalues*/
-		20					/*nblocks*/
-    );
-	if (f == NULL) {
-		return NULL;
-    }
-	
 	current_frame = f;
-	next_instr = GETUSTRINGVALUE(f->f_code->co_code);
-	stack_pointer = f->f_valuestack;
-	
-	if (arg != NULL) {
-		INCREF(arg);
-		PUSH(arg);
-	}
+	next_instr = FIRST_INSTR() + f->f_lasti;
+	stack_pointer = f->f_stacktop;
+	lineno = f->f_lineno;
 	
 	why = WHY_NOT;
 	err = 0;
 	x = None;	/* Not a reference, just anything non-NULL */
-	lineno = -1;
 	
-	for (;;) {
-		static int ticker;
-		
-		/* Do periodic things */
-		if (--ticker < 0) {
-			ticker = 100;
-			if (intrcheck()) {
-				err_set(KeyboardInterrupt);
-				why = WHY_EXCEPTION;
-				tb_here(f, INSTR_OFFSET(), lineno);
-				break;
-			}
+	/* Do periodic things.  This is also done on backward jumps, so that
+	   both loops and deep recursion can be interrupted */
+	if (--ticker < 0) {
+		ticker = 100;
+		if (intrcheck()) {
+			err_set(KeyboardInterrupt);
+			why = WHY_EXCEPTION;
+			tb_here(f, INSTR_OFFSET(), lineno);
 		}
-		
+	}
+	
+	while (why == WHY_NOT) {
 		/* Extract opcode and argument */
 		opcode = NEXTOP();
 		if (HAS_ARG(opcode)) {
@@ -729,142 +1196,221 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 
 	        /* case STOP_CODE: this is an error! */
 
-	        case POP_TOP:
+	        TARGET(POP_TOP)
 		        v = POP();
 		        DECREF(v);
-		        break;
+		        FAST_DISPATCH();
 
-	        case ROT_TWO:
+	        TARGET(ROT_TWO)
 		        v = POP();
 		        w = POP();
 		        PUSH(v);
 		        PUSH(w);
-		        break;
+		        FAST_DISPATCH();
 
-	        case ROT_THREE:
+	        TARGET(ROT_THREE)
 		        v = POP();
 		        w = POP();
 		        x = POP();
 		        PUSH(v);
 		        PUSH(x);
 		        PUSH(w);
-		        break;
+		        FAST_DISPATCH();
 
-	        case DUP_TOP:
+	        TARGET(DUP_TOP)
 		        v = TOP();
 		        INCREF(v);
 		        PUSH(v);
-		        break;
+		        FAST_DISPATCH();
 
-	        case UNARY_POSITIVE:
+	        TARGET(UNARY_POSITIVE)
 		        v = POP();
 		        x = pos(v);
 		        DECREF(v);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case UNARY_NEGATIVE:
+	        TARGET(UNARY_NEGATIVE)
 		        v = POP();
 		        x = neg(v);
 		        DECREF(v);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case UNARY_NOT:
+	        TARGET(UNARY_NOT)
 		        v = POP();
 		        x = not(v);
 		        DECREF(v);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case UNARY_CONVERT:
+	        TARGET(UNARY_CONVERT)
 		        v = POP();
 		        x = reprobject(v);
 		        DECREF(v);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case UNARY_CALL:
+	        TARGET(UNARY_CALL)
 		        v = POP();
 		        if (is_classmethodobject(v) || is_funcobject(v)) {
-			        x = call_function(v, (object *)NULL);
+			        newf = call_frame(v, (object **)NULL, 0);
+			        x = NULL;
                 }
 		        else {
-			        x = call_builtin(v, (object *)NULL);
+			        newf = NULL;
+			        x = call_builtin(v, (object **)NULL, 0);
                 }
 		        DECREF(v);
+		        if (newf != NULL) {
+			        goto start_frame;
+                }
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case BINARY_MULTIPLY:
+	        TARGET(BINARY_MULTIPLY)
 		        w = POP();
 		        v = POP();
 		        x = mul(v, w);
 		        DECREF(v);
 		        DECREF(w);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case BINARY_DIVIDE:
+	        TARGET(BINARY_DIVIDE)
 		        w = POP();
 		        v = POP();
 		        x = divide(v, w);
 		        DECREF(v);
 		        DECREF(w);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case BINARY_MODULO:
+	        TARGET(BINARY_MODULO)
 		        w = POP();
 		        v = POP();
 		        x = rem(v, w);
 		        DECREF(v);
 		        DECREF(w);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case BINARY_ADD:
+	        TARGET(BINARY_ADD)
 		        w = POP();
 		        v = POP();
+		        if (IS_TAGGED(v) && IS_TAGGED(w)) {
+			        /* Can't overflow a long; no references to drop */
+			        x = newintobject(GETINTVALUE(v) + GETINTVALUE(w));
+			        PUSH(x);
+			        DISPATCH();
+		        }
 		        x = add(v, w);
 		        DECREF(v);
 		        DECREF(w);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case BINARY_SUBTRACT:
+	        TARGET(BINARY_SUBTRACT)
 		        w = POP();
 		        v = POP();
+		        if (IS_TAGGED(v) && IS_TAGGED(w)) {
+			        x = newintobject(GETINTVALUE(v) - GETINTVALUE(w));
+			        PUSH(x);
+			        DISPATCH();
+		        }
 		        x = sub(v, w);
 		        DECREF(v);
 		        DECREF(w);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case BINARY_SUBSCR:
+	        TARGET(BINARY_SUBSCR)
 		        w = POP();
 		        v = POP();
 		        x = apply_subscript(v, w);
 		        DECREF(v);
 		        DECREF(w);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case BINARY_CALL:
+	        TARGET(CALL_RANGE)
+		        /* BINARY_CALL making the sequence of a for loop, which
+		           needn't be a list if the function is range() */
+		        if (range_function == NULL) {
+			        range_function = getbuiltin("range");
+                }
+		        if (stack_pointer[-2] == range_function) {
+			        long start, step;
+			        int len;
+			        w = TOP();
+			        if (is_tupleobject(w) && gettuplesize(w) >= 2) {
+				        err = getrangeargs(((tupleobject *)w)->ob_item,
+                                           gettuplesize(w), &start, &step,
+                                           &len);
+                    }
+			        else {
+				        err = getrangeargs(stack_pointer - 1, 1, &start, &step,
+                                           &len);
+                    }
+			        w = POP();
+			        v = POP();
+			        if (err == 0) {
+				        x = newrangeobject(start, step, len);
+                    }
+			        else {
+				        x = NULL;
+                    }
+			        DECREF(v);
+			        DECREF(w);
+			        PUSH(x);
+			        DISPATCH();
+		        }
+		        /* Fall through */
+	        TARGET(BINARY_CALL)
+		        v = stack_pointer[-2];
+		        if (is_classmethodobject(v) || is_funcobject(v)) {
+			        newf = call_frame(v, stack_pointer - 1, 1);
+			        x = NULL;
+                }
+		        else {
+			        newf = NULL;
+			        x = call_builtin(v, stack_pointer - 1, 1);
+                }
 		        w = POP();
 		        v = POP();
+		        DECREF(v);
+		        DECREF(w);
+		        if (newf != NULL) {
+			        goto start_frame;
+                }
+		        PUSH(x);
+		        DISPATCH();
+
+	        /* The arguments of CALL_FUNCTION and CALL_METHOD stay on the
+	           stack during the call, and are passed as an array */
+	        TARGET_WITH_ARG(CALL_FUNCTION)
+		        v = stack_pointer[-oparg - 1];
 		        if (is_classmethodobject(v) || is_funcobject(v)) {
-			        x = call_function(v, w);
+			        newf = call_frame(v, stack_pointer - oparg, oparg);
+			        x = NULL;
                 }
 		        else {
-			        x = call_builtin(v, w);
+			        newf = NULL;
+			        x = call_builtin(v, stack_pointer - oparg, oparg);
                 }
+		        for (; --oparg >= 0; ) {
+			        w = POP();
+			        DECREF(w);
+		        }
+		        v = POP();
 		        DECREF(v);
-		        DECREF(w);
+		        if (newf != NULL) {
+			        goto start_frame;
+                }
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case SLICE + 0:
+	        TARGET(SLICE)
 	        case SLICE + 1:
 	        case SLICE + 2:
 	        case SLICE + 3:
@@ -886,9 +1432,9 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 		        XDECREF(v);
 		        XDECREF(w);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case STORE_SLICE + 0:
+	        TARGET(STORE_SLICE)
 	        case STORE_SLICE + 1:
 	        case STORE_SLICE + 2:
 	        case STORE_SLICE + 3:
@@ -911,9 +1457,9 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 		        DECREF(u);
 		        XDECREF(v);
 		        XDECREF(w);
-		        break;
+		        DISPATCH();
 
-	        case DELETE_SLICE + 0:
+	        TARGET(DELETE_SLICE)
 	        case DELETE_SLICE + 1:
 	        case DELETE_SLICE + 2:
 	        case DELETE_SLICE + 3:
@@ -935,9 +1481,9 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 		        DECREF(u);
 		        XDECREF(v);
 		        XDECREF(w);
-		        break;
+		        DISPATCH();
 
-	        case STORE_SUBSCR:
+	        TARGET(STORE_SUBSCR)
 		        w = POP();
 		        v = POP();
 		        u = POP();
@@ -946,18 +1492,18 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 		        DECREF(u);
 		        DECREF(v);
 		        DECREF(w);
-		        break;
+		        DISPATCH();
 
-	        case DELETE_SUBSCR:
+	        TARGET(DELETE_SUBSCR)
 		        w = POP();
 		        v = POP();
 		        /* del v[w] */
 		        err = assign_subscript(v, w, (object *)NULL);
 		        DECREF(v);
 		        DECREF(w);
-		        break;
+		        DISPATCH();
 
-	        case PRINT_EXPR:
+	        TARGET(PRINT_EXPR)
 		        v = POP();
 		        fp = sysgetfile("stdout", stdout);
 		        /* Print value except if procedure result */
@@ -967,9 +1513,9 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 			        fprintf(fp, "\n");
 		        }
 		        DECREF(v);
-		        break;
+		        DISPATCH();
 
-	        case PRINT_ITEM:
+	        TARGET(PRINT_ITEM)
 		        v = POP();
 		        fp = sysgetfile("stdout", stdout);
 		        if (needspace) {
@@ -991,19 +1537,19 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 			        needspace = 1;
 		        }
 		        DECREF(v);
-		        break;
+		        DISPATCH();
 
-	        case PRINT_NEWLINE:
+	        TARGET(PRINT_NEWLINE)
 		        fp = sysgetfile("stdout", stdout);
 		        fprintf(fp, "\n");
 		        needspace = 0;
-		        break;
+		        FAST_DISPATCH();
 
-	        case BREAK_LOOP:
+	        TARGET(BREAK_LOOP)
 		        why = WHY_BREAK;
 		        break;
 
-	        case RAISE_EXCEPTION:
+	        TARGET(RAISE_EXCEPTION)
 		        v = POP();
 		        w = POP();
 		        if (!is_stringobject(w)) {
@@ -1017,39 +1563,44 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 		        why = WHY_EXCEPTION;
 		        break;
 
-	        case LOAD_LOCALS:
+	        TARGET(LOAD_LOCALS)
 		        v = f->f_locals;
 		        INCREF(v);
 		        PUSH(v);
-		        break;
+		        DISPATCH();
 
-	        case RETURN_VALUE:
+	        TARGET(RETURN_VALUE)
 		        retval = POP();
 		        why = WHY_RETURN;
 		        break;
 
-	        case REQUIRE_ARGS:
+	        TARGET(YIELD_VALUE)
+		        retval = POP();
+		        why = WHY_YIELD;
+		        break;
+
+	        TARGET(REQUIRE_ARGS)
 		        if (EMPTY()) {
 			        err_setstr(TypeError, "function expects argument(s)");
 			        why = WHY_EXCEPTION;
 		        }
-		        break;
+		        DISPATCH();
 
-	        case REFUSE_ARGS:
+	        TARGET(REFUSE_ARGS)
 		        if (!EMPTY()) {
 			        err_setstr(TypeError, "function expects no argument(s)");
 			        why = WHY_EXCEPTION;
 		        }
-		        break;
+		        DISPATCH();
 
-	        case BUILD_FUNCTION:
+	        TARGET(BUILD_FUNCTION)
 		        v = POP();
 		        x = newfuncobject(v, f->f_globals);
 		        DECREF(v);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case POP_BLOCK:
+	        TARGET(POP_BLOCK)
 		        {
 			        block *b = pop_block(f);
 			        while (STACK_LEVEL() > b->b_level) {
@@ -1057,9 +1608,9 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 				        DECREF(v);
 			        }
 		        }
-		        break;
+		        FAST_DISPATCH();
 
-	        case END_FINALLY:
+	        TARGET(END_FINALLY)
 		        v = POP();
 		        if (is_intobject(v)) {
 			        why = (enum why_code) getintvalue(v);
@@ -1081,32 +1632,32 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 			        why = WHY_EXCEPTION;
 		        }
 		        DECREF(v);
-		        break;
+		        DISPATCH();
 
-	        case BUILD_CLASS:
+	        TARGET(BUILD_CLASS)
 		        w = POP();
 		        v = POP();
 		        x = build_class(v, w);
 		        PUSH(x);
 		        DECREF(v);
 		        DECREF(w);
-		        break;
+		        DISPATCH();
 
-	        case STORE_NAME:
-		        name = GETNAME(oparg);
+	        TARGET_WITH_ARG(STORE_NAME)
+		        w = GETNAMEV(oparg);
 		        v = POP();
-		        err = dictinsert(f->f_locals, name, v);
+		        err = dict2insert(f->f_locals, w, v);
 		        DECREF(v);
-		        break;
+		        DISPATCH();
 
-	        case DELETE_NAME:
-		        name = GETNAME(oparg);
-		        if ((err = dictremove(f->f_locals, name)) != 0) {
-			        err_setstr(NameError, name);
+	        TARGET_WITH_ARG(DELETE_NAME)
+		        w = GETNAMEV(oparg);
+		        if ((err = dict2remove(f->f_locals, w)) != 0) {
+			        err_setstr(NameError, getstringvalue(w));
                 }
-		        break;
+		        DISPATCH();
 
-	        case UNPACK_TUPLE:
+	        TARGET_WITH_ARG(UNPACK_TUPLE)
 		        v = POP();
 		        if (!is_tupleobject(v)) {
 			        err_setstr(TypeError, "unpack non-tuple");
@@ -1124,9 +1675,9 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 			        }
 		        }
 		        DECREF(v);
-		        break;
+		        DISPATCH();
 
-	        case UNPACK_LIST:
+	        TARGET_WITH_ARG(UNPACK_LIST)
 		        v = POP();
 		        if (!is_listobject(v)) {
 			        err_setstr(TypeError, "unpack non-list");
@@ -1144,50 +1695,206 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 			        }
 		        }
 		        DECREF(v);
-		        break;
+		        DISPATCH();
 
-	        case STORE_ATTR:
+	        TARGET_WITH_ARG(STORE_ATTR)
 		        name = GETNAME(oparg);
 		        v = POP();
 		        u = POP();
 		        err = setattr(v, name, u); /* v.name = u */
 		        DECREF(v);
 		        DECREF(u);
-		        break;
+		        DISPATCH();
 
-	        case DELETE_ATTR:
+	        TARGET_WITH_ARG(DELETE_ATTR)
 		        name = GETNAME(oparg);
 		        v = POP();
 		        err = setattr(v, name, (object *)NULL);
 		        /* del v.name */
 		        DECREF(v);
-		        break;
+		        DISPATCH();
+
+	        /* For v.name(...), LOAD_METHOD leaves the function and v on
+	           the stack if name is a method of class member v, so that
+	           CALL_METHOD can call it without making a class method object;
+	           likewise for a built-in method of v's type, for which it
+	           leaves the method object without a self from the type's
+	           index.  Otherwise it leaves NULL and the attribute. */
+	        TARGET_WITH_ARG(LOAD_METHOD)
+		        name = GETNAME(oparg);
+		        v = POP();
+		        if (is_classmemberobject(v)
+                    && (x = classmembergetmethod(v, name)) != NULL)
+                {
+			        PUSH(x);
+			        PUSH(v);
+			        FAST_DISPATCH();
+		        }
+		        if (TYPEOF(v)->tp_methods != NULL
+                    && (u = getmethodindex(TYPEOF(v)->tp_methods)) != NULL
+                    && (x = dict2lookup(u, GETNAMEV(oparg))) != NULL)
+                {
+			        INCREF(x);
+			        PUSH(x);
+			        PUSH(v);
+			        FAST_DISPATCH();
+		        }
+		        x = getattr(v, name);
+		        DECREF(v);
+		        PUSH((object *)NULL);
+		        PUSH(x);
+		        DISPATCH();
+
+	        TARGET_WITH_ARG(CALL_METHOD)
+		        v = stack_pointer[-oparg - 1];
+		        u = stack_pointer[-oparg - 2];
+		        newf = NULL;
+		        x = NULL;
+		        if (u != NULL) {
+			        if (is_methodobject(u)) {
+				        x = fastcallmethod(u, v, stack_pointer - oparg,
+                                           oparg);
+                    }
+			        else {
+				        newf = function_frame(u, v, stack_pointer - oparg,
+                                              oparg);
+                    }
+		        }
+		        else if (is_classmethodobject(v) || is_funcobject(v)) {
+			        newf = call_frame(v, stack_pointer - oparg, oparg);
+                }
+		        else {
+			        x = call_builtin(v, stack_pointer - oparg, oparg);
+                }
+		        for (; --oparg >= 0; ) {
+			        w = POP();
+			        DECREF(w);
+		        }
+		        v = POP();
+		        DECREF(v);
+		        u = POP();
+		        XDECREF(u);
+		        if (newf != NULL) {
+			        goto start_frame;
+                }
+		        PUSH(x);
+		        DISPATCH();
+
+	        /* A call of a Python function doesn't run its frame, newf, in
+	           a recursive call of eval_frame(); the current frame waits in
+	           the call instruction, and the loop goes on with newf until
+	           it ends and the loop returns to the caller (see the end of
+	           the loop) */
+	        start_frame:
+		        if (newf->f_code->co_flags & CO_GENERATOR) {
+			        /* The call only makes a generator to run newf */
+			        recursion_depth--;
+			        x = newgenobject(newf);
+			        DECREF(newf);
+			        PUSH(x);
+			        DISPATCH();
+		        }
+		        f->f_stacktop = stack_pointer;
+		        f->f_lasti = INSTR_OFFSET() - (HAS_ARG(opcode) ? 3 : 1);
+		        f->f_lineno = lineno;
+		        f = newf;
+		        current_frame = f;
+		        next_instr = FIRST_INSTR() + f->f_lasti;
+		        stack_pointer = f->f_stacktop;
+		        lineno = f->f_lineno;
+		        x = None;
+        #ifdef TRACE
+		        trace = dictlookup(f->f_globals, "__trace__") != NULL;
+        #endif
+		        /* Check for interrupts, so deep recursion can be stopped */
+		        if (--ticker < 0) {
+			        ticker = 100;
+			        if (intrcheck()) {
+				        err_set(KeyboardInterrupt);
+				        tb_here(f, INSTR_OFFSET(), lineno);
+				        why = WHY_RERAISE;
+				        break;
+			        }
+		        }
+		        FAST_DISPATCH();
 
-	        case LOAD_CONST:
+	        TARGET_WITH_ARG(LOAD_CONST)
 		        x = GETCONST(oparg);
 		        INCREF(x);
 		        PUSH(x);
-		        break;
+		        FAST_DISPATCH();
 
-	        case LOAD_NAME:
-		        name = GETNAME(oparg);
-		        x = dictlookup(f->f_locals, name);
-		        if (x == NULL) {
-			        x = dictlookup(f->f_globals, name);
-			        if (x == NULL) {
-				        x = getbuiltin(name);
-                    }
-		        }
+	        TARGET_WITH_ARG(LOAD_NAME)
+		        x = load_name(f->f_code, oparg, f->f_locals, f->f_globals);
+		        if (x != NULL) {
+			        INCREF(x);
+                }
+		        PUSH(x);
+		        DISPATCH();
+
+	        TARGET_WITH_ARG(LOAD_GLOBAL)
+		        x = load_name(f->f_code, oparg, (object *)NULL, f->f_globals);
+		        if (x != NULL) {
+			        INCREF(x);
+                }
+		        PUSH(x);
+		        DISPATCH();
+
+	        TARGET_WITH_ARG(LOAD_FAST)
+		        x = GETLOCAL(oparg);
 		        if (x == NULL) {
-			        err_setstr(NameError, name);
+			        x = unbound_local(f, oparg);
                 }
-		        else {
+		        if (x != NULL) {
 			        INCREF(x);
                 }
 		        PUSH(x);
-		        break;
+		        DISPATCH();
+
+	        TARGET_WITH_ARG(LOAD_NAME_ATTR)
+		        v = load_name(f->f_code, oparg, f->f_locals, f->f_globals);
+		        if (v == NULL) {
+			        x = NULL;
+			        break;
+		        }
+		        next_instr++; /* Skip the LOAD_ATTR */
+		        oparg = NEXTARG();
+		        x = getattr(v, GETNAME(oparg));
+		        PUSH(x);
+		        DISPATCH();
 
-	        case BUILD_TUPLE:
+	        TARGET_WITH_ARG(LOAD_FAST_ATTR)
+		        v = GETLOCAL(oparg);
+		        if (v == NULL && (v = unbound_local(f, oparg)) == NULL) {
+			        x = NULL;
+			        break;
+		        }
+		        next_instr++; /* Skip the LOAD_ATTR */
+		        oparg = NEXTARG();
+		        x = getattr(v, GETNAME(oparg));
+		        PUSH(x);
+		        DISPATCH();
+
+	        TARGET_WITH_ARG(STORE_FAST)
+		        v = POP();
+		        w = GETLOCAL(oparg);
+		        SETLOCAL(oparg, v);
+		        XDECREF(w);
+		        FAST_DISPATCH();
+
+	        TARGET_WITH_ARG(DELETE_FAST)
+		        x = GETLOCAL(oparg);
+		        if (x == NULL) {
+			        err_setstr(NameError,
+                               GETITEMNAME(f->f_code->co_varnames, oparg));
+			        err = -1;
+			        break;
+		        }
+		        SETLOCAL(oparg, NULL);
+		        DECREF(x);
+		        DISPATCH();
+
+	        TARGET_WITH_ARG(BUILD_TUPLE)
 		        x = newtupleobject(oparg);
 		        if (x != NULL) {
 			        for (; --oparg >= 0;) {
@@ -1199,9 +1906,9 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 			        }
 			        PUSH(x);
 		        }
-		        break;
+		        DISPATCH();
 
-	        case BUILD_LIST:
+	        TARGET_WITH_ARG(BUILD_LIST)
 		        x =  newlistobject(oparg);
 		        if (x != NULL) {
 			        for (; --oparg >= 0;) {
@@ -1213,107 +1920,150 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 			        }
 			        PUSH(x);
 		        }
-		        break;
+		        DISPATCH();
 
-	        case BUILD_MAP:
+	        TARGET_WITH_ARG(BUILD_MAP)
 		        x = newdictobject();
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case LOAD_ATTR:
+	        TARGET_WITH_ARG(LOAD_ATTR)
 		        name = GETNAME(oparg);
 		        v = POP();
 		        x = getattr(v, name);
 		        DECREF(v);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case COMPARE_OP:
+	        TARGET_WITH_ARG(COMPARE_OP)
 		        w = POP();
 		        v = POP();
-		        x = cmp_outcome((enum cmp_op)oparg, v, w);
-		        DECREF(v);
-		        DECREF(w);
+		        if (IS_TAGGED(v) && IS_TAGGED(w) && oparg <= GE) {
+			        x = cmp_tagged((enum cmp_op)oparg, v, w);
+                }
+		        else {
+			        x = cmp_outcome((enum cmp_op)oparg, v, w);
+			        DECREF(v);
+			        DECREF(w);
+		        }
 		        PUSH(x);
-		        break;
+		        DISPATCH();
+
+	        TARGET_WITH_ARG(COMPARE_JUMP_IF_FALSE)
+		        w = POP();
+		        v = POP();
+		        if (IS_TAGGED(v) && IS_TAGGED(w) && oparg <= GE) {
+			        x = cmp_tagged((enum cmp_op)oparg, v, w);
+                }
+		        else {
+			        x = cmp_outcome((enum cmp_op)oparg, v, w);
+			        DECREF(v);
+			        DECREF(w);
+		        }
+		        PUSH(x);
+		        if (x == NULL) {
+			        break;
+                }
+		        next_instr++; /* Skip the JUMP_IF_FALSE */
+		        oparg = NEXTARG();
+		        if (!testbool(x)) {
+			        JUMPBY(oparg);
+                }
+		        DISPATCH();
 
-	        case IMPORT_NAME:
+	        TARGET_WITH_ARG(IMPORT_NAME)
 		        name = GETNAME(oparg);
 		        x = import_module(name);
 		        XINCREF(x);
 		        PUSH(x);
-		        break;
+		        DISPATCH();
 
-	        case IMPORT_FROM:
+	        TARGET_WITH_ARG(IMPORT_FROM)
 		        name = GETNAME(oparg);
 		        v = TOP();
 		        err = import_from(f->f_locals, v, name);
-		        break;
+		        DISPATCH();
 
-	        case JUMP_FORWARD:
+	        TARGET_WITH_ARG(JUMP_FORWARD)
 		        JUMPBY(oparg);
-		        break;
+		        FAST_DISPATCH();
 
-	        case JUMP_IF_FALSE:
+	        TARGET_WITH_ARG(JUMP_IF_FALSE)
 		        if (!testbool(TOP())) {
 			        JUMPBY(oparg);
                 }
-		        break;
+		        FAST_DISPATCH();
 
-	        case JUMP_IF_TRUE:
+	        TARGET_WITH_ARG(JUMP_IF_TRUE)
 		        if (testbool(TOP())) {
 			        JUMPBY(oparg);
                 }
-		        break;
+		        FAST_DISPATCH();
 
-	        case JUMP_ABSOLUTE:
+	        TARGET_WITH_ARG(JUMP_ABSOLUTE)
 		        JUMPTO(oparg);
-		        break;
+		        /* Every loop ends in a backward jump; check for interrupts */
+		        if (--ticker < 0) {
+			        ticker = 100;
+			        if (intrcheck()) {
+				        err_set(KeyboardInterrupt);
+				        why = WHY_EXCEPTION;
+				        break;
+			        }
+		        }
+		        FAST_DISPATCH();
 
-	        case FOR_LOOP:
+	        TARGET(GET_ITER)
+		        v = POP();
+		        x = getiter(v);
+		        DECREF(v);
+		        PUSH(x);
+		        DISPATCH();
+
+	        TARGET_WITH_ARG(FOR_LOOP)
 		        /* for v in s: ...
-		           On entry: stack contains s, i.
-		           On exit: stack contains s, i + 1, s[i];
-		           but if loop exhausted:
-		           s, i are popped, and we jump */
-		        w = POP(); /* Loop index */
-		        v = POP(); /* Sequence object */
-		        u = loop_subscript(v, w);
+		           On entry: stack contains an iterator over s (see
+		           GET_ITER).
+		           On exit: stack contains the iterator and its next item;
+		           but if the iterator is exhausted:
+		           it is popped, and we jump */
+		        v = TOP();
+		        u = (*TYPEOF(v)->tp_iternext)(v);
 		        if (u != NULL) {
-			        PUSH(v);
-			        x = newintobject(getintvalue(w)+1);
-			        PUSH(x);
-			        DECREF(w);
 			        PUSH(u);
+			        FAST_DISPATCH();
 		        }
-		        else {
-			        DECREF(v);
-			        DECREF(w);
-			        /* A NULL can mean "s exhausted" but also an error: */
-			        if (err_occurred()) {
-				        why = WHY_EXCEPTION;
-                    }
-			        else {
-				        JUMPBY(oparg);
-                    }
+		        v = POP();
+		        DECREF(v);
+		        /* A NULL can mean "iterator exhausted" but also an error: */
+		        if (err_occurred()) {
+			        why = WHY_EXCEPTION;
+			        DISPATCH();
 		        }
-		        break;
+		        JUMPBY(oparg);
+		        FAST_DISPATCH();
 
-	        case SETUP_LOOP:
+	        TARGET_WITH_ARG(SETUP_LOOP)
 	        case SETUP_EXCEPT:
 	        case SETUP_FINALLY:
 		        setup_block(f, opcode, INSTR_OFFSET() + oparg, STACK_LEVEL());
-		        break;
+		        FAST_DISPATCH();
+
+	        TARGET(NOP)
+		        FAST_DISPATCH();
 
-	        case SET_LINENO:
+	        TARGET_WITH_ARG(SET_LINENO)
         #ifdef TRACE
 		        if (trace) {
 			        printf("--- Line %d ---\n", oparg);
                 }
         #endif
 		        lineno = oparg;
-		        break;
+		        FAST_DISPATCH();
 
+#ifdef USE_COMPUTED_GOTOS
+	        _unknown_opcode:
+#endif
 	        default:
 		        fprintf(stderr, "XXX lineno: %d, opcode: %d\n", lineno,
                         opcode);
@@ -1332,6 +2082,12 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 			err = 0;
 		}
 
+		/* A generator's frame is always the first one of the loop (see
+		   resume_frame()); it is suspended after the loop */
+		if (why == WHY_YIELD) {
+			break;
+        }
+
 #ifndef NDEBUG
 		/* Double-check exception status */
 		if (why == WHY_EXCEPTION || why == WHY_RERAISE) {
@@ -1357,6 +2113,7 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 			tb_here(f, lasti, lineno);
 		}
 		
+	unwind:
 		/* For the rest, treat WHY_RERAISE as WHY_EXCEPTION */
 		if (why == WHY_RERAISE) {
 			why = WHY_EXCEPTION;
@@ -1412,21 +2169,68 @@ eval_code(codeobject *co, object *globals, object *locals, object *arg)
 			}
 		} /* unwind stack */
 
-		/* End the loop if we still have an error (or return) */
+		/* End the loop if we still have an error (or return) in the
+		   first frame; in any other, return to its caller */
 		if (why != WHY_NOT) {
-			break;
-        }
+			if (f == entry) {
+				break;
+            }
+			while (!EMPTY()) {
+				v = POP();
+				XDECREF(v);
+			}
+			newf = f;
+			newf->f_stacktop = NULL;
+			f = f->f_back;
+			current_frame = f;
+			recursion_depth--;
+			DECREF(newf);
+			next_instr = FIRST_INSTR() + f->f_lasti;
+			opcode = NEXTOP();
+			if (HAS_ARG(opcode)) {
+				next_instr += 2;
+            }
+			stack_pointer = f->f_stacktop;
+			lineno = f->f_lineno;
+#ifdef TRACE
+			trace = dictlookup(f->f_globals, "__trace__") != NULL;
+#endif
+			if (why == WHY_RETURN) {
+				PUSH(retval);
+				why = WHY_NOT;
+				x = None;
+			}
+			else {
+				/* The exception passes through the call instruction */
+				tb_here(f, f->f_lasti, lineno);
+				why = WHY_RERAISE;
+				goto unwind;
+			}
+		}
 		
 	} /* main loop */
 	
+	/* Suspend a generator's frame, keeping its value stack */
+	if (why == WHY_YIELD) {
+		f->f_stacktop = stack_pointer;
+		f->f_lasti = INSTR_OFFSET();
+		f->f_lineno = lineno;
+		current_frame = f->f_back;
+		recursion_depth--;
+		DECREF(f);
+		return retval;
+	}
+
 	/* Pop remaining stack entries */
 	while (!EMPTY()) {
 		v = POP();
 		XDECREF(v);
 	}
+	f->f_stacktop = NULL;
 	
 	/* Restore previous frame and release the current one */
 	current_frame = f->f_back;
+	recursion_depth--;
 	DECREF(f);
 	
 	if (why == WHY_RETURN) {
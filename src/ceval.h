@@ -10,6 +10,15 @@ extern "C" {
 object *eval_code(codeobject *, object *, object *, object *);
 object *getglobals(void);
 object *getlocals(void);
+void mergelocals(void);
+
+/* Run a suspended generator frame, see genobject.c */
+struct _frame;
+object *resume_frame(struct _frame *);
+
+/* Python calls nest without using the C stack; their depth is limited */
+int getrecursionlimit(void);
+void setrecursionlimit(int);
 
 void printtraceback(FILE *);
 void flushline();
@@ -5,6 +5,7 @@
 #include "object.h"
 #include "objimpl.h"
 #include "tupleobject.h"
+#include "listobject.h"
 #include "dictobject.h"
 #include "funcobject.h"
 #include "classobject.h"
@@ -16,23 +17,66 @@ typedef struct {
 	OB_HEAD
 	object	*cl_bases;		/* A tuple */
 	object	*cl_methods;	/* A dictionary */
+	object	*cl_mro;		/* A list: all base classes in lookup order */
+	object	*cl_cache;		/* A dictionary, or NULL: see class_getattr() */
+	unsigned long cl_cacheversion;
 } classobject;
 
+/* Append the classes searched for attributes of base, after base itself,
+   to list; classes already there are left out, since they would not find
+   anything the first time either */
+static int
+addbases(object *list, classobject *base)
+{
+	int n = getlistsize(list), i, j;
+	object *v;
+
+	for (i = -1; i < getlistsize(base->cl_mro); i++) {
+		v = i < 0 ? (object *)base : getlistitem(base->cl_mro, i);
+		for (j = 0; j < n && getlistitem(list, j) != v; j++)
+			;
+		if (j == n) {
+			if (addlistitem(list, v) != 0) {
+				return -1;
+            }
+			n++;
+		}
+	}
+	return 0;
+}
+
 /* object *bases: NULL or tuple of classobjects! */
 object *
 newclassobject(object *bases, object *methods)
 {
-	classobject *op = NEWOBJ(classobject, &Classtype);
+	classobject *op;
+	object *mro = newlistobject(0);
 
-	if (op == NULL) {
+	if (mro == NULL) {
 		return NULL;
     }
+	if (bases != NULL) {
+		for (int i = 0; i < gettuplesize(bases); i++) {
+			if (addbases(mro, (classobject *)gettupleitem(bases, i)) != 0) {
+				DECREF(mro);
+				return NULL;
+			}
+		}
+	}
+	op = NEWOBJ(classobject, &Classtype);
+	if (op == NULL) {
+		DECREF(mro);
+		return NULL;
+	}
 	if (bases != NULL) {
 		INCREF(bases);
     }
 	op->cl_bases = bases;
 	INCREF(methods);
 	op->cl_methods = methods;
+	op->cl_mro = mro;
+	op->cl_cache = NULL;
+	op->cl_cacheversion = 0;
 	return (object *)op;
 }
 
@@ -45,30 +89,74 @@ class_dealloc(classobject *op)
 		DECREF(op->cl_bases);
     }
 	DECREF(op->cl_methods);
-	free((ANY *)op);
+	DECREF(op->cl_mro);
+	XDECREF(op->cl_cache);
+	DEL(op);
 }
 
+/* Attributes are looked up in the class's own dictionary first, then in
+   those of its bases, depth first and left to right, as listed in cl_mro.
+   What is found in the bases is remembered in cl_cache.  The cache is
+   valid as long as none of the dictionaries on the way changes; since a
+   dictionary changing gets a version number higher than any given out
+   before, it suffices to compare the highest version among them with the
+   one at the time the cache was filled. */
 static object *
 class_getattr(register classobject *op, register char *name)
 {
 	register object *v = dictlookup(op->cl_methods, name);
+	register int i, n = getlistsize(op->cl_mro);
+	unsigned long version, w;
 
 	if (v != NULL) {
 		INCREF(v);
 		return v;
 	}
-	if (op->cl_bases != NULL) {
-		for (int i = 0; i < gettuplesize(op->cl_bases); i++) {
-			v = class_getattr((classobject *)gettupleitem(op->cl_bases, i),
-                               name);
-			if (v != NULL) {
+	if (n == 0) {
+		err_setstr(NameError, name);
+		return NULL;
+	}
+	version = GETDICTVERSION(op->cl_methods);
+	for (i = 0; i < n; i++) {
+		w = GETDICTVERSION(((classobject *)getlistitem(op->cl_mro, i))
+                           ->cl_methods);
+		if (w > version) {
+			version = w;
+        }
+	}
+	if (op->cl_cache != NULL) {
+		if (op->cl_cacheversion == version) {
+			if ((v = dictlookup(op->cl_cache, name)) != NULL) {
+				INCREF(v);
 				return v;
-            }
-			err_clear();
+			}
+		}
+		else {
+			DECREF(op->cl_cache);
+			op->cl_cache = NULL;
 		}
 	}
-	err_setstr(NameError, name);
-	return NULL;
+	for (i = 0; i < n; i++) {
+		v = dictlookup(((classobject *)getlistitem(op->cl_mro, i))
+                       ->cl_methods, name);
+		if (v != NULL) {
+			break;
+        }
+	}
+	if (v == NULL) {
+		err_setstr(NameError, name);
+		return NULL;
+	}
+	if (op->cl_cache == NULL) {
+		op->cl_cache = newdictobject();
+		op->cl_cacheversion = version;
+	}
+	/* Failing to cache is not an error */
+	if (op->cl_cache == NULL || dictinsert(op->cl_cache, name, v) != 0) {
+		err_clear();
+    }
+	INCREF(v);
+	return v;
 }
 
 typeobject Classtype = {
@@ -128,7 +216,7 @@ classmember_dealloc(register classmemberobject *cm)
 	if (cm->cm_attr != NULL) {
 		DECREF(cm->cm_attr);
     }
-	free((ANY *)cm);
+	DEL(cm);
 }
 
 static object *
@@ -154,6 +242,32 @@ classmember_getattr(register classmemberobject *cm, register char *name)
 	return NULL;
 }
 
+/* Return the function that classmember_getattr() would bind to cm for name,
+   without making the class method object; NULL, without an error set, if
+   the attribute is not a method (or doesn't exist at all).  Used by the
+   LOAD_METHOD instruction, which passes cm along as the first argument
+   itself. */
+object *
+classmembergetmethod(object *op, char *name)
+{
+	register classmemberobject *cm = (classmemberobject *)op;
+	register object *v;
+
+	if (dictlookup(cm->cm_attr, name) != NULL) {
+		return NULL;
+    }
+	v = class_getattr(cm->cm_class, name);
+	if (v == NULL) {
+		err_clear();
+		return NULL;
+	}
+	if (!is_funcobject(v)) {
+		DECREF(v);
+		return NULL;
+	}
+	return v;
+}
+
 static int
 classmember_setattr(classmemberobject *cm, char *name, object *v)
 {
@@ -252,7 +366,7 @@ classmethod_dealloc(register classmethodobject *cm)
 {
 	DECREF(cm->cm_func);
 	DECREF(cm->cm_self);
-	free((ANY *)cm);
+	DEL(cm);
 }
 
 typeobject Classmethodtype = {
@@ -13,15 +13,16 @@ if we can fix that later, sigh... */
 
 extern typeobject Classtype, Classmembertype, Classmethodtype;
 
-#define is_classobject(op)           ((op)->ob_type == &Classtype)
-#define is_classmemberobject(op)     ((op)->ob_type == &Classmembertype)
-#define is_classmethodobject(op)     ((op)->ob_type == &Classmethodtype)
+#define is_classobject(op)           (TYPEOF(op) == &Classtype)
+#define is_classmemberobject(op)     (TYPEOF(op) == &Classmembertype)
+#define is_classmethodobject(op)     (TYPEOF(op) == &Classmethodtype)
 
 extern object *newclassobject(object *, object *);
 extern object *newclassmemberobject(object *);
 extern object *newclassmethodobject(object *, object *);
 extern object *classmethodgetfunc(object *);
 extern object *classmethodgetself(object *);
+extern object *classmembergetmethod(object *, char *);
 
 #ifdef __cplusplus
 }
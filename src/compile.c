@@ -1,7 +1,6 @@
 /* Compile an expression node to intermediate code */
 
 /* XXX TO DO:
-   XXX Compute maximum needed stack sizes while compiling
    XXX Generate simple jump for break/return outside 'try...finally'
    XXX Include function name in code (and module names?) */
 
@@ -30,7 +29,11 @@ static struct memberlist code_memberlist[] = {
 	{"co_code",		T_OBJECT,	OFF(co_code)},
 	{"co_consts",	T_OBJECT,	OFF(co_consts)},
 	{"co_names",	T_OBJECT,	OFF(co_names)},
+	{"co_varnames",	T_OBJECT,	OFF(co_varnames)},
 	{"co_filename",	T_OBJECT,	OFF(co_filename)},
+	{"co_flags",	T_INT,		OFF(co_flags)},
+	{"co_stacksize",T_INT,		OFF(co_stacksize)},
+	{"co_maxblocks",T_INT,		OFF(co_maxblocks)},
 	{NULL}	/* Sentinel */
 };
 
@@ -46,7 +49,9 @@ code_dealloc(codeobject *co)
 	XDECREF(co->co_code);
 	XDECREF(co->co_consts);
 	XDECREF(co->co_names);
+	XDECREF(co->co_varnames);
 	XDECREF(co->co_filename);
+	XDEL(co->co_namecache);
 	DEL(co);
 }
 
@@ -67,19 +72,21 @@ typeobject Codetype = {
 	0,							/*tp_as_mapping*/
 };
 
-static codeobject *
-newcodeobject(object *code, object *consts, object *names, char *filename)
+codeobject *
+newcodeobject(object *code, object *consts, object *names, object *varnames,
+              int flags, int stacksize, int maxblocks, char *filename)
 {
 	codeobject *co;
 
 	/* Check argument types */
 	if (code == NULL || !is_stringobject(code) || consts == NULL
-        || !is_listobject(consts) || names == NULL || !is_listobject(names))
+        || !is_listobject(consts) || names == NULL || !is_listobject(names)
+        || varnames == NULL || !is_listobject(varnames))
     {
 		err_badcall();
 		return NULL;
 	}
-	/* Make sure the list of names contains only strings */
+	/* Make sure the lists of names contain only strings */
 	for (int i = getlistsize(names); --i >= 0; ) {
 		object *v = getlistitem(names, i);
 		if (v == NULL || !is_stringobject(v)) {
@@ -87,6 +94,13 @@ newcodeobject(object *code, object *consts, object *names, char *filename)
 			return NULL;
 		}
 	}
+	for (int i = getlistsize(varnames); --i >= 0; ) {
+		object *v = getlistitem(varnames, i);
+		if (v == NULL || !is_stringobject(v)) {
+			err_badcall();
+			return NULL;
+		}
+	}
 	co = NEWOBJ(codeobject, &Codetype);
 	if (co != NULL) {
 		INCREF(code);
@@ -95,6 +109,12 @@ newcodeobject(object *code, object *consts, object *names, char *filename)
 		co->co_consts = consts;
 		INCREF(names);
 		co->co_names = names;
+		INCREF(varnames);
+		co->co_varnames = varnames;
+		co->co_flags = flags;
+		co->co_stacksize = stacksize;
+		co->co_maxblocks = maxblocks;
+		co->co_namecache = NULL;
 		if ((co->co_filename = newstringobject(filename)) == NULL) {
 			DECREF(co);
 			co = NULL;
@@ -103,15 +123,29 @@ newcodeobject(object *code, object *consts, object *names, char *filename)
 	return co;
 }
 
+/* Hash index over the constants or names list, so that com_add() needs no
+   linear search.  A slot holds a list index plus one; zero means empty. */
+struct listindex {
+	int 	*li_slots;		/* NULL until the first item is added */
+	int 	li_mask;		/* number of slots - 1 */
+};
+
 /* Data structure used internally */
 struct compiling {
 	object *c_code;			/* string */
 	object *c_consts;		/* list of objects */
 	object *c_names;		/* list of strings (names) */
+	object *c_varnames;		/* list of strings (local variable names) */
+	struct listindex c_constindex;	/* index over c_consts */
+	struct listindex c_nameindex;	/* index over c_names */
+	int 	c_flags;		/* CO_... flags for the code object */
+	int 	c_stacksize;	/* max value stack depth, see com_stackdepth */
+	int 	c_maxblocks;	/* max block stack depth */
 	int 	c_nexti;		/* index into c_code */
 	int 	c_errors;		/* counts errors occurred */
 	int 	c_infunction;	/* set when compiling a function */
 	int 	c_loops;		/* counts nested loops */
+	int 	c_finally;		/* counts nested try blocks with a 'finally' */
 	char 	*c_filename;	/* filename of current node */
 };
 
@@ -125,7 +159,8 @@ static void com_addint(struct compiling *, int);
 static void com_addoparg(struct compiling *, int, int);
 static void com_addfwref(struct compiling *, int, int *);
 static void com_backpatch(struct compiling *, int);
-static int com_add(struct compiling *, object *, object *);
+static int com_add(struct compiling *, object *, struct listindex *,
+                   object *);
 static int com_addconst(struct compiling *, object *);
 static int com_addname(struct compiling *, object *);
 static void com_addopname(struct compiling *, int, node *);
@@ -134,26 +169,37 @@ static int
 com_init(struct compiling *c, char *filename)
 {
 	if ((c->c_code = newsizedstringobject((char *)NULL, 0)) == NULL) {
-		goto fail_3;
+		goto fail_4;
     }
 	if ((c->c_consts = newlistobject(0)) == NULL) {
-		goto fail_2;
+		goto fail_3;
     }
 	if ((c->c_names = newlistobject(0)) == NULL) {
+		goto fail_2;
+    }
+	if ((c->c_varnames = newlistobject(0)) == NULL) {
 		goto fail_1;
     }
+	c->c_constindex.li_slots = NULL;
+	c->c_nameindex.li_slots = NULL;
+	c->c_flags = 0;
+	c->c_stacksize = 0;
+	c->c_maxblocks = 0;
 	c->c_nexti = 0;
 	c->c_errors = 0;
 	c->c_infunction = 0;
+	c->c_finally = 0;
 	c->c_loops = 0;
 	c->c_filename = filename;
 	return 1;
 	
   	fail_1:
-		DECREF(c->c_consts);
+		DECREF(c->c_names);
   	fail_2:
-		DECREF(c->c_code);
+		DECREF(c->c_consts);
   	fail_3:
+		DECREF(c->c_code);
+  	fail_4:
  		return 0;
 }
 
@@ -163,6 +209,9 @@ com_free(struct compiling *c)
 	XDECREF(c->c_code);
 	XDECREF(c->c_consts);
 	XDECREF(c->c_names);
+	XDECREF(c->c_varnames);
+	XDEL(c->c_constindex.li_slots);
+	XDEL(c->c_nameindex.li_slots);
 }
 
 static void
@@ -246,33 +295,104 @@ com_backpatch(struct compiling *c, int anchor)
 
 /* Handle constants and names uniformly */
 
+/* Constants of a type without a hash function (code objects, None) only
+   compare equal to themselves, so their address will do */
+static unsigned long
+com_hash(object *v)
+{
+	long h;
+
+	if (TYPEOF(v)->tp_hash != NULL) {
+		if ((h = hashobject(v)) != -1) {
+			return (unsigned long)h;
+        }
+		err_clear();
+	}
+	return (unsigned long)v >> 3;
+}
+
+/* Return the slot of the index holding v, or the empty slot where it
+   belongs.  The probe sequence mixes in the high bits of the hash, so runs
+   of consecutive ints don't turn into long collision chains. */
 static int
-com_add(struct compiling *c, object *list, object *v)
+com_lookindex(struct listindex *li, object *list, object *v)
 {
-	int n = getlistsize(list);
+	unsigned long perturb = com_hash(v);
+	int j = perturb & li->li_mask;
+	object *w;
 
-	for (int i = n; --i >= 0;) {
-		object *w = getlistitem(list, i);
-		if (cmpobject(v, w) == 0) {
-			return i;
+	while (li->li_slots[j] != 0) {
+		w = getlistitem(list, li->li_slots[j] - 1);
+		if (TYPEOF(w) == TYPEOF(v) && cmpobject(v, w) == 0) {
+			break;
         }
+		perturb >>= 5;
+		j = (5 * j + 1 + perturb) & li->li_mask;
 	}
-	if (addlistitem(list, v) != 0) {
+	return j;
+}
+
+/* Make the index big enough for one more item, rebuilding it from the list */
+static int
+com_growindex(struct listindex *li, object *list)
+{
+	int n = getlistsize(list);
+	int size, i;
+	int *oldslots = li->li_slots;
+
+	if (oldslots != NULL && 2 * (n + 1) <= li->li_mask + 1) {
+		return 0;
+    }
+	for (size = 16; size < 4 * (n + 1); size <<= 1)
+		;
+	if ((li->li_slots = NEW(int, size)) == NULL) {
+		li->li_slots = oldslots;
+		err_nomem();
+		return -1;
+	}
+	li->li_mask = size - 1;
+	for (i = 0; i < size; i++) {
+		li->li_slots[i] = 0;
+    }
+	for (i = 0; i < n; i++) {
+		li->li_slots[com_lookindex(li, list, getlistitem(list, i))] = i + 1;
+    }
+	XDEL(oldslots);
+	return 0;
+}
+
+static int
+com_add(struct compiling *c, object *list, struct listindex *li, object *v)
+{
+	int n = getlistsize(list);
+	int j;
+
+	if (com_growindex(li, list) != 0) {
 		c->c_errors++;
+		return 0;
+	}
+	j = com_lookindex(li, list, v);
+	if (li->li_slots[j] != 0) {
+		return li->li_slots[j] - 1;
     }
+	if (addlistitem(list, v) != 0) {
+		c->c_errors++;
+		return n;
+	}
+	li->li_slots[j] = n + 1;
 	return n;
 }
 
 static int
 com_addconst(struct compiling *c, object *v)
 {
-	return com_add(c, c->c_consts, v);
+	return com_add(c, c->c_consts, &c->c_constindex, v);
 }
 
 static int
 com_addname(struct compiling *c, object *v)
 {
-	return com_add(c, c->c_names, v);
+	return com_add(c, c->c_names, &c->c_nameindex, v);
 }
 
 static void
@@ -289,7 +409,7 @@ com_addopname(struct compiling *c, int op, node *n)
 		REQ(n, NAME);
 		name = STR(n);
 	}
-	if ((v = newstringobject(name)) == NULL) {
+	if ((v = internstring(name)) == NULL) {
 		c->c_errors++;
 		i = 255;
 	}
@@ -319,9 +439,8 @@ parsenumber(char *s)
 static object *
 parsestr(char *s)
 {
-	object *v;
+	stringbuilder sb;
 	int len, c;
-	char *buf, *p;
 
 	if (*s != '\'') {
 		err_badcall();
@@ -336,54 +455,56 @@ parsestr(char *s)
 	if (strchr(s, '\\') == NULL) {
 		return newsizedstringobject(s, len);
     }
-	v = newsizedstringobject((char *)NULL, len);
-	p = buf = getstringvalue(v);
+	/* Escapes only shrink, so len characters are always enough */
+	if (sb_init(&sb, len) != 0) {
+		return NULL;
+    }
 	while (*s != '\0' && *s != '\'') {
 		if (*s != '\\') {
-			*p++ = *s++;
+			SB_PUTCHAR(&sb, *s++);
 			continue;
 		}
 		s++;
 		switch (*s++) {
 			/* XXX This assumes ASCII! */
 			case '\\':
-                *p++ = '\\';
+                SB_PUTCHAR(&sb, '\\');
                 break;
 
 			case '\'':
-                *p++ = '\'';
+                SB_PUTCHAR(&sb, '\'');
                 break;
 
 			case 'b':
-                *p++ = '\b';
+                SB_PUTCHAR(&sb, '\b');
                 break;
 
 			case 'f':
-                *p++ = '\014';
+                SB_PUTCHAR(&sb, '\014');
                 break; /* FF */
 
 			case 't':
-                *p++ = '\t';
+                SB_PUTCHAR(&sb, '\t');
                 break;
 
 			case 'n':
-                *p++ = '\n';
+                SB_PUTCHAR(&sb, '\n');
                 break;
 
 			case 'r':
-                *p++ = '\r';
+                SB_PUTCHAR(&sb, '\r');
                 break;
 
 			case 'v':
-                *p++ = '\013';
+                SB_PUTCHAR(&sb, '\013');
                 break; /* VT */
 
 			case 'E':
-                *p++ = '\033';
+                SB_PUTCHAR(&sb, '\033');
             	break; /* ESC, not C */
 
 			case 'a':
-                *p++ = '\007';
+                SB_PUTCHAR(&sb, '\007');
             	break; /* BEL, not classic C */
 
 			case '0':
@@ -401,13 +522,13 @@ parsestr(char *s)
 						c = (c << 3) + *s++ - '0';
                     }
 				}
-				*p++ = c;
+				SB_PUTCHAR(&sb, c);
 				break;
 
 			case 'x':
 				if (isxdigit(*s)) {
 					sscanf(s, "%x", &c);
-					*p++ = c;
+					SB_PUTCHAR(&sb, c);
 					do {
 						s++;
 					} while (isxdigit(*s));
@@ -416,13 +537,12 @@ parsestr(char *s)
 
 			/* FALLTHROUGH */
 			default:
-                *p++ = '\\';
-            	*p++ = s[-1];
+                SB_PUTCHAR(&sb, '\\');
+            	SB_PUTCHAR(&sb, s[-1]);
                 break;
 		}
 	}
-	resizestring(&v, (int)(p - buf));
-	return v;
+	return sb_finish(&sb);
 }
 
 static void
@@ -551,17 +671,40 @@ com_apply_subscript(struct compiling *c, node *n)
 	}
 }
 
+/* node *n: testlist, the arguments of a call.  Two or more arguments are
+   left on the stack one by one instead of being made into a tuple, and
+   their number is returned; otherwise 1, for the single object pushed. */
+static int
+com_call_args(struct compiling *c, node *n)
+{
+	int i;
+
+	REQ(n, testlist);
+	if (NCH(n) < 3) {
+		com_node(c, n);
+		return 1;
+	}
+	for (i = 0; i < NCH(n); i += 2) {
+		com_node(c, CHILD(n, i));
+    }
+	return (NCH(n) + 1) / 2;
+}
+
 /* node *n: EITHER testlist OR ')' */
 static void
 com_call_function(struct compiling *c, node *n)
 {
+	int nargs;
+
 	if (TYPE(n) == RPAR) {
 		com_addbyte(c, UNARY_CALL);
 	}
-	else {
-		com_node(c, n);
+	else if ((nargs = com_call_args(c, n)) == 1) {
 		com_addbyte(c, BINARY_CALL);
 	}
+	else {
+		com_addoparg(c, CALL_FUNCTION, nargs);
+	}
 }
 
 static void
@@ -593,6 +736,45 @@ com_apply_trailer(struct compiling *c, node *n)
 	}
 }
 
+/* Is trailer n a member selection followed by a call, as in x.name(...)? */
+static int
+is_method_call(node *n, int i)
+{
+	return TYPE(CHILD(CHILD(n, i), 0)) == DOT
+           && TYPE(CHILD(CHILD(n, i + 1), 0)) == LPAR;
+}
+
+/* node *n: '.' NAME trailer followed by '(' [testlist] ')' trailer.
+   The method and the object it is selected from are left on the stack by
+   LOAD_METHOD and called together by CALL_METHOD, so the common case of a
+   class member's method needs no class method object (see ceval.c). */
+static void
+com_call_method(struct compiling *c, node *n, node *call)
+{
+	com_addopname(c, LOAD_METHOD, CHILD(n, 1));
+	if (TYPE(CHILD(call, 1)) == RPAR) {
+		com_addoparg(c, CALL_METHOD, 0);
+	}
+	else {
+		com_addoparg(c, CALL_METHOD, com_call_args(c, CHILD(call, 1)));
+	}
+}
+
+/* Apply trailers i up to end of node n */
+static void
+com_apply_trailers(struct compiling *c, node *n, int i, int end)
+{
+	for (; i < end; i++) {
+		if (i + 1 < end && is_method_call(n, i)) {
+			com_call_method(c, CHILD(n, i), CHILD(n, i + 1));
+			i++;
+		}
+		else {
+			com_apply_trailer(c, CHILD(n, i));
+        }
+	}
+}
+
 static void
 com_factor(struct compiling *c, node *n)
 {
@@ -607,9 +789,7 @@ com_factor(struct compiling *c, node *n)
 	}
 	else {
 		com_atom(c, CHILD(n, 0));
-		for (int i = 1; i < NCH(n); i++) {
-			com_apply_trailer(c, CHILD(n, i));
-        }
+		com_apply_trailers(c, n, 1, NCH(n));
 	}
 }
 
@@ -1017,12 +1197,9 @@ com_assign(struct compiling *c, node *n, int assigning)
 					return;
 				}
 				if (NCH(n) > 1) { /* trailer present */
-					int i;
 					com_node(c, CHILD(n, 0));
-					for (i = 1; i + 1 < NCH(n); i++) {
-						com_apply_trailer(c, CHILD(n, i));
-					} /* NB i is still alive */
-					com_assign_trailer(c, CHILD(n, i), assigning);
+					com_apply_trailers(c, n, 1, NCH(n) - 1);
+					com_assign_trailer(c, CHILD(n, NCH(n) - 1), assigning);
 					return;
 				}
 				n = CHILD(n, 0);
@@ -1119,6 +1296,28 @@ com_return_stmt(struct compiling *c, node *n)
 	com_addbyte(c, RETURN_VALUE);
 }
 
+/* A function containing 'yield' is a generator: calling it makes a
+   generator object, and each yield suspends its frame (see ceval.c).
+   The 'finally' clause of a try statement would not run if a generator
+   was dropped while suspended in its body, so that is not allowed. */
+
+static void
+com_yield_stmt(struct compiling *c, node *n)
+{
+	REQ(n, yield_stmt); /* 'yield' testlist NEWLINE */
+	if (!c->c_infunction) {
+		err_setstr(TypeError, "'yield' outside function");
+		c->c_errors++;
+	}
+	else if (c->c_finally > 0) {
+		err_setstr(TypeError, "'yield' inside 'try' with 'finally'");
+		c->c_errors++;
+	}
+	com_node(c, CHILD(n, 1));
+	com_addbyte(c, YIELD_VALUE);
+	c->c_flags |= CO_GENERATOR;
+}
+
 static void
 com_raise_stmt(struct compiling *c, node *n)
 {
@@ -1209,22 +1408,45 @@ com_while_stmt(struct compiling *c, node *n)
 	com_backpatch(c, break_anchor);
 }
 
+/* node *n: the exprlist a for loop runs over.  If it is a call of range(),
+   as in 'for i in range(n)', the call is made by CALL_RANGE, which gives a
+   range object instead of a list if the function is the built-in range(). */
+static void
+com_loop_sequence(struct compiling *c, node *n)
+{
+	node *f = n, *call;
+
+	/* exprlist -> expr -> term -> factor */
+	while (NCH(f) == 1 && (TYPE(f) == exprlist || TYPE(f) == expr
+                           || TYPE(f) == term))
+    {
+		f = CHILD(f, 0);
+    }
+	if (TYPE(f) == factor && NCH(f) == 2 && TYPE(CHILD(f, 0)) == atom
+        && TYPE(CHILD(CHILD(f, 0), 0)) == NAME
+        && strcmp(STR(CHILD(CHILD(f, 0), 0)), "range") == 0)
+    {
+		call = CHILD(f, 1);
+		if (TYPE(CHILD(call, 0)) == LPAR && NCH(call) == 3) {
+			com_atom(c, CHILD(f, 0));
+			com_node(c, CHILD(call, 1));
+			com_addbyte(c, CALL_RANGE);
+			return;
+		}
+	}
+	com_node(c, n);
+}
+
 static void
 com_for_stmt(struct compiling *c, node *n)
 {
-	object *v;
 	int break_anchor = 0, anchor = 0, begin;
 
 	REQ(n, for_stmt);
 	/* 'for' exprlist 'in' exprlist ':' suite ['else' ':' suite] */
 	com_addfwref(c, SETUP_LOOP, &break_anchor);
-	com_node(c, CHILD(n, 3));
-	v = newintobject(0L);
-	if (v == NULL) {
-		c->c_errors++;
-    }
-	com_addoparg(c, LOAD_CONST, com_addconst(c, v));
-	XDECREF(v);
+	com_loop_sequence(c, CHILD(n, 3));
+	com_addbyte(c, GET_ITER);
 	begin = c->c_nexti;
 	com_addoparg(c, SET_LINENO, n->n_lineno);
 	com_addfwref(c, FOR_LOOP, &anchor);
@@ -1336,6 +1558,9 @@ com_try_stmt(struct compiling *c, node *n)
 		/* Have an 'except' clause */
 		com_addfwref(c, SETUP_EXCEPT, &except_anchor);
 	}
+	if (finally_anchor) {
+		c->c_finally++;
+    }
 	com_node(c, CHILD(n, 2));
 	if (except_anchor) {
 		int end_anchor = 0;
@@ -1381,6 +1606,7 @@ com_try_stmt(struct compiling *c, node *n)
 	}
 	if (finally_anchor) {
 		node *ch;
+		c->c_finally--;
 		com_addbyte(c, POP_BLOCK);
 		com_addoparg(c, LOAD_CONST, com_addconst(c, None));
 		com_backpatch(c, finally_anchor);
@@ -1523,6 +1749,10 @@ com_node(struct compiling *c, node *n)
 			com_return_stmt(c, n);
 			break;
 
+		case yield_stmt:
+			com_yield_stmt(c, n);
+			break;
+
 		case raise_stmt:
 			com_raise_stmt(c, n);
 			break;
@@ -1640,6 +1870,611 @@ com_file_input(struct compiling *c, node *n)
 	}
 }
 
+/* Turn the name references of a function body into references to local
+   variable slots.  Every name that is stored or deleted in the function
+   becomes a local variable; the others are looked up with LOAD_GLOBAL.
+   A function using 'from ... import' or calling exec() is left alone,
+   since these bind names that are not known until run time. */
+
+static int
+com_findname(object *list, object *v)
+{
+	for (int i = getlistsize(list); --i >= 0; ) {
+		if (getlistitem(list, i) == v) {
+			return i;
+        }
+	}
+	return -1;
+}
+
+static void
+com_optimize(struct compiling *c)
+{
+	unsigned char *code, *next_instr, *cur_instr;
+	unsigned char *end_instr;
+	int opcode, oparg, i;
+	object *name;
+
+	if (c->c_errors) {
+		return;
+    }
+	code = (unsigned char *)getstringvalue(c->c_code);
+	end_instr = code + c->c_nexti;
+
+	/* First pass: collect the local variable names */
+	for (next_instr = code; next_instr < end_instr; ) {
+		opcode = *next_instr++;
+		oparg = 0;
+		if (HAS_ARG(opcode)) {
+			oparg = next_instr[0] + (next_instr[1] << 8);
+			next_instr += 2;
+		}
+		if (opcode == IMPORT_FROM) {
+			return;
+        }
+		if (opcode == LOAD_NAME && strcmp(getstringvalue(
+                getlistitem(c->c_names, oparg)), "exec") == 0)
+        {
+			return;
+		}
+		if (opcode == STORE_NAME || opcode == DELETE_NAME) {
+			name = getlistitem(c->c_names, oparg);
+			if (com_findname(c->c_varnames, name) < 0
+                && addlistitem(c->c_varnames, name) != 0)
+            {
+				c->c_errors++;
+				return;
+			}
+		}
+	}
+
+	/* Second pass: rewrite the name instructions in place */
+	for (next_instr = code; next_instr < end_instr; ) {
+		cur_instr = next_instr;
+		opcode = *next_instr++;
+		if (!HAS_ARG(opcode)) {
+			continue;
+        }
+		oparg = next_instr[0] + (next_instr[1] << 8);
+		next_instr += 2;
+		if (opcode != LOAD_NAME && opcode != STORE_NAME
+            && opcode != DELETE_NAME)
+        {
+			continue;
+        }
+		/* Names are interned, so identity is enough */
+		i = com_findname(c->c_varnames, getlistitem(c->c_names, oparg));
+		if (i < 0) {
+			/* Only LOAD_NAME can get here */
+			*cur_instr = LOAD_GLOBAL;
+			continue;
+		}
+		switch (opcode) {
+			case LOAD_NAME:
+				*cur_instr = LOAD_FAST;
+				break;
+			case STORE_NAME:
+				*cur_instr = STORE_FAST;
+				break;
+			case DELETE_NAME:
+				*cur_instr = DELETE_FAST;
+				break;
+		}
+		cur_instr[1] = i & 0xff;
+		cur_instr[2] = i >> 8;
+	}
+	c->c_flags |= CO_OPTIMIZED;
+}
+
+/* Peephole optimizer.  When optimizeflag is set (option -O), the finished
+   code of each code object is improved in place:
+   - jumps to unconditional jumps are made to go to the final target, and
+     so are conditional jumps to the same conditional jump;
+   - a SET_LINENO immediately followed by another one is removed;
+   - binary operators on two constant ints, two floats or two strings,
+     and unary minus on a constant number, are computed at compile time;
+   - LOAD_NAME or LOAD_FAST followed by LOAD_ATTR, and COMPARE_OP followed
+     by JUMP_IF_FALSE, become superinstructions.
+   Removed instructions are first overwritten by NOPs, which com_squeeze()
+   deletes afterwards.  Nothing is folded across a jump target. */
+
+int optimizeflag;
+
+#define GETARG(code, i)	((code)[(i) + 1] + ((code)[(i) + 2] << 8))
+#define SETARG(code, i, x) \
+	((code)[(i) + 1] = (x) & 0xff, (code)[(i) + 2] = (x) >> 8)
+#define INSTRSIZE(op)	(HAS_ARG(op) ? 3 : 1)
+
+/* Return the target of the jump instruction at offset i, or -1 */
+static int
+jump_target(unsigned char *code, int i)
+{
+	switch (code[i]) {
+		case JUMP_FORWARD:
+		case JUMP_IF_FALSE:
+		case JUMP_IF_TRUE:
+		case FOR_LOOP:
+		case SETUP_LOOP:
+		case SETUP_EXCEPT:
+		case SETUP_FINALLY:
+			return i + 3 + GETARG(code, i);
+		case JUMP_ABSOLUTE:
+			return GETARG(code, i);
+		default:
+			return -1;
+	}
+}
+
+static object *
+fold_binary(int opcode, object *v, object *w)
+{
+	number_methods *nb;
+
+	if (TYPEOF(v) != TYPEOF(w)) {
+		return NULL;
+    }
+	if (is_stringobject(v)) {
+		if (opcode != BINARY_ADD) {
+			return NULL;
+        }
+		return (*TYPEOF(v)->tp_as_sequence->sq_concat)(v, w);
+	}
+	if (!is_intobject(v) && !is_floatobject(v)) {
+		return NULL;
+    }
+	nb = TYPEOF(v)->tp_as_number;
+	switch (opcode) {
+		case BINARY_ADD:
+			return (*nb->nb_add)(v, w);
+		case BINARY_SUBTRACT:
+			return (*nb->nb_subtract)(v, w);
+		case BINARY_MULTIPLY:
+			return (*nb->nb_multiply)(v, w);
+		case BINARY_DIVIDE:
+			return (*nb->nb_divide)(v, w);
+		case BINARY_MODULO:
+			return (*nb->nb_remainder)(v, w);
+		default:
+			return NULL;
+	}
+}
+
+/* Delete the NOPs from the code and fix up the jumps */
+static void
+com_squeeze(struct compiling *c)
+{
+	unsigned char *code = (unsigned char *)getstringvalue(c->c_code);
+	int n = c->c_nexti;
+	int *map;
+	int i, j, k, len, target;
+
+	if ((map = NEW(int, n + 1)) == NULL) {
+		err_nomem();
+		c->c_errors++;
+		return;
+	}
+	/* Map old offsets to new ones; a NOP maps to what follows it */
+	for (i = j = 0; i < n; i += len) {
+		len = code[i] == NOP ? 1 : INSTRSIZE(code[i]);
+		for (k = 0; k < len; k++) {
+			map[i + k] = j;
+        }
+		if (code[i] != NOP) {
+			j += len;
+        }
+	}
+	map[n] = j;
+	/* Move the instructions down; a jump is fixed before it is moved */
+	for (i = 0; i < n; i += len) {
+		len = INSTRSIZE(code[i]);
+		if (code[i] == NOP) {
+			continue;
+        }
+		if ((target = jump_target(code, i)) >= 0) {
+			if (code[i] == JUMP_ABSOLUTE) {
+				SETARG(code, i, map[target]);
+            }
+			else {
+				SETARG(code, i, map[target] - (map[i] + 3));
+            }
+		}
+		for (k = 0; k < len; k++) {
+			code[map[i] + k] = code[i + k];
+        }
+	}
+	c->c_nexti = map[n];
+	DEL(map);
+	com_done(c);
+}
+
+static void
+com_peephole(struct compiling *c)
+{
+	unsigned char *code;
+	char *istarget;
+	int *hist; /* Offsets of the instructions before this one, no NOPs */
+	int n, i, j, a, b, nhist, opcode, target, hops;
+	object *v, *w, *x;
+
+	if (c->c_errors) {
+		return;
+    }
+	code = (unsigned char *)getstringvalue(c->c_code);
+	n = c->c_nexti;
+	istarget = NEW(char, n + 1);
+	hist = NEW(int, n + 1);
+	if (istarget == NULL || hist == NULL) {
+		/* Not optimizing is no error */
+		goto done;
+	}
+
+	/* Find the jump targets */
+	for (i = 0; i <= n; i++) {
+		istarget[i] = 0;
+    }
+	for (i = 0; i < n; i += INSTRSIZE(code[i])) {
+		if ((target = jump_target(code, i)) >= 0) {
+			istarget[target] = 1;
+        }
+	}
+
+	/* Jump threading */
+	for (i = 0; i < n; i += INSTRSIZE(code[i])) {
+		opcode = code[i];
+		if (opcode != JUMP_FORWARD && opcode != JUMP_ABSOLUTE
+            && opcode != JUMP_IF_FALSE && opcode != JUMP_IF_TRUE)
+        {
+			continue;
+        }
+		target = jump_target(code, i);
+		for (hops = 0; hops < 10 && target < n; hops++) {
+			j = code[target];
+			if (j != JUMP_FORWARD && j != JUMP_ABSOLUTE
+                && (j != opcode || opcode == JUMP_FORWARD
+                    || opcode == JUMP_ABSOLUTE))
+            {
+				break;
+            }
+			target = jump_target(code, target);
+		}
+		if (target == jump_target(code, i)) {
+			continue;
+        }
+		if (opcode == JUMP_ABSOLUTE) {
+			SETARG(code, i, target);
+        }
+		else if (target > i) {
+			SETARG(code, i, target - (i + 3));
+        }
+		else if (opcode == JUMP_FORWARD) {
+			code[i] = JUMP_ABSOLUTE;
+			SETARG(code, i, target);
+		}
+		else {
+			continue; /* A conditional jump can't go back */
+        }
+		istarget[target] = 1;
+	}
+
+	/* Redundant SET_LINENO instructions */
+	for (i = 0, a = -1; i < n; i += INSTRSIZE(code[i])) {
+		if (code[i] == SET_LINENO) {
+			if (a >= 0) {
+				code[a] = code[a + 1] = code[a + 2] = NOP;
+            }
+			a = i;
+		}
+		else if (code[i] != NOP) {
+			a = -1;
+        }
+	}
+
+	/* Constant folding and superinstructions */
+	nhist = 0;
+	for (i = 0; i < n; i += INSTRSIZE(code[i])) {
+		opcode = code[i];
+		if (opcode == NOP) {
+			continue;
+        }
+		if (istarget[i]) {
+			nhist = 0; /* Don't look back across a jump target */
+        }
+		switch (opcode) {
+			case BINARY_ADD:
+			case BINARY_SUBTRACT:
+			case BINARY_MULTIPLY:
+			case BINARY_DIVIDE:
+			case BINARY_MODULO:
+				if (nhist < 2) {
+					break;
+                }
+				a = hist[nhist - 2];
+				b = hist[nhist - 1];
+				if (code[a] != LOAD_CONST || code[b] != LOAD_CONST
+                    || istarget[b])
+                {
+					break;
+                }
+				v = getlistitem(c->c_consts, GETARG(code, a));
+				w = getlistitem(c->c_consts, GETARG(code, b));
+				if ((x = fold_binary(opcode, v, w)) == NULL) {
+					err_clear();
+					break;
+				}
+				j = com_addconst(c, x);
+				DECREF(x);
+				SETARG(code, a, j);
+				code[b] = code[b + 1] = code[b + 2] = code[i] = NOP;
+				nhist--;
+				continue;
+			case UNARY_NEGATIVE:
+				if (nhist < 1) {
+					break;
+                }
+				a = hist[nhist - 1];
+				if (code[a] != LOAD_CONST) {
+					break;
+                }
+				v = getlistitem(c->c_consts, GETARG(code, a));
+				if (!is_intobject(v) && !is_floatobject(v)) {
+					break;
+                }
+				if ((x = (*TYPEOF(v)->tp_as_number->nb_negative)(v))
+                    == NULL)
+                {
+					err_clear();
+					break;
+				}
+				j = com_addconst(c, x);
+				DECREF(x);
+				SETARG(code, a, j);
+				code[i] = NOP;
+				continue;
+			case LOAD_ATTR:
+				if (nhist < 1) {
+					break;
+                }
+				a = hist[nhist - 1];
+				if (code[a] == LOAD_NAME) {
+					code[a] = LOAD_NAME_ATTR;
+                }
+				else if (code[a] == LOAD_FAST) {
+					code[a] = LOAD_FAST_ATTR;
+                }
+				break;
+			case JUMP_IF_FALSE:
+				if (nhist >= 1 && code[hist[nhist - 1]] == COMPARE_OP) {
+					code[hist[nhist - 1]] = COMPARE_JUMP_IF_FALSE;
+                }
+				break;
+		}
+		hist[nhist++] = i;
+	}
+	if (c->c_errors == 0) {
+		com_squeeze(c);
+    }
+
+  done:
+	XDEL(istarget);
+	XDEL(hist);
+}
+
+/* Compute the maximum depths of the value stack and the block stack, by
+   following every path through the code and recording the stack depth on
+   entry to each instruction.  Where paths join, the larger depth is kept.
+   Exception handlers are entered with three more items (traceback, value
+   and exception) than there were at the SETUP_EXCEPT or SETUP_FINALLY;
+   a 'finally' clause may also be entered with fewer, and the END_FINALLY
+   leaves the stack as it was at the SETUP_FINALLY.  The argument, if
+   any, is on the stack when the code starts. */
+
+static int
+stack_effect(int opcode, int oparg)
+{
+	switch (opcode) {
+		case POP_TOP:
+			return -1;
+		case DUP_TOP:
+			return 1;
+		case BINARY_MULTIPLY:
+		case BINARY_DIVIDE:
+		case BINARY_MODULO:
+		case BINARY_ADD:
+		case BINARY_SUBTRACT:
+		case BINARY_SUBSCR:
+		case BINARY_CALL:
+		case CALL_RANGE:
+			return -1;
+		case LOAD_METHOD:
+			return 1;
+		case CALL_METHOD:
+			return -1 - oparg;
+		case CALL_FUNCTION:
+			return -oparg;
+		case SLICE + 1:
+		case SLICE + 2:
+			return -1;
+		case SLICE + 3:
+			return -2;
+		case STORE_SLICE + 0:
+			return -2;
+		case STORE_SLICE + 1:
+		case STORE_SLICE + 2:
+			return -3;
+		case STORE_SLICE + 3:
+			return -4;
+		case DELETE_SLICE + 0:
+			return -1;
+		case DELETE_SLICE + 1:
+		case DELETE_SLICE + 2:
+			return -2;
+		case DELETE_SLICE + 3:
+			return -3;
+		case STORE_SUBSCR:
+			return -3;
+		case DELETE_SUBSCR:
+			return -2;
+		case PRINT_EXPR:
+		case PRINT_ITEM:
+			return -1;
+		case RAISE_EXCEPTION:
+			return -2;
+		case LOAD_LOCALS:
+			return 1;
+		case RETURN_VALUE:
+		case YIELD_VALUE:
+			return -1;
+		case END_FINALLY:
+			return -3;
+		case BUILD_CLASS:
+			return -1;
+		case STORE_NAME:
+		case STORE_FAST:
+			return -1;
+		case UNPACK_TUPLE:
+		case UNPACK_LIST:
+			return oparg - 1;
+		case STORE_ATTR:
+			return -2;
+		case DELETE_ATTR:
+			return -1;
+		case LOAD_CONST:
+		case LOAD_NAME:
+		case LOAD_GLOBAL:
+		case LOAD_FAST:
+		case LOAD_NAME_ATTR:
+		case LOAD_FAST_ATTR:
+		case BUILD_MAP:
+		case IMPORT_NAME:
+			return 1;
+		case BUILD_TUPLE:
+		case BUILD_LIST:
+			return 1 - oparg;
+		case COMPARE_OP:
+		case COMPARE_JUMP_IF_FALSE:
+			return -1;
+		case FOR_LOOP:
+			return 1; /* Or -1 when the loop is exhausted */
+		default:
+			return 0;
+	}
+}
+
+static void
+com_pushdepth(int *depth, int *blocks, int *todo, int *ntodo, char *queued,
+              int target, int d, int b)
+{
+	if (d > depth[target]) {
+		depth[target] = d;
+		blocks[target] = b;
+		if (!queued[target]) {
+			queued[target] = 1;
+			todo[(*ntodo)++] = target;
+		}
+	}
+}
+
+static void
+com_stackdepth(struct compiling *c)
+{
+	unsigned char *code;
+	int *depth, *blocks, *todo;
+	char *queued;
+	int n, ntodo, i, next, opcode, oparg, d, b;
+
+	if (c->c_errors) {
+		return;
+    }
+	code = (unsigned char *)getstringvalue(c->c_code);
+	n = c->c_nexti;
+	depth = NEW(int, n + 1);
+	blocks = NEW(int, n + 1);
+	todo = NEW(int, n + 1);
+	queued = NEW(char, n + 1);
+	if (depth == NULL || blocks == NULL || todo == NULL || queued == NULL) {
+		err_nomem();
+		c->c_errors++;
+		goto done;
+	}
+	for (i = 0; i < n; i++) {
+		depth[i] = -1;
+		queued[i] = 0;
+	}
+	ntodo = 0;
+	if (n > 0) {
+		com_pushdepth(depth, blocks, todo, &ntodo, queued, 0, 1, 0);
+    }
+	while (ntodo > 0) {
+		i = todo[--ntodo];
+		queued[i] = 0;
+		d = depth[i];
+		b = blocks[i];
+		if (d > c->c_stacksize) {
+			c->c_stacksize = d;
+        }
+		if (b > c->c_maxblocks) {
+			c->c_maxblocks = b;
+        }
+		opcode = code[i];
+		next = i + 1;
+		oparg = 0;
+		if (HAS_ARG(opcode)) {
+			oparg = code[i + 1] + (code[i + 2] << 8);
+			next = i + 3;
+		}
+		d += stack_effect(opcode, oparg);
+		switch (opcode) {
+			case RETURN_VALUE:
+			case RAISE_EXCEPTION:
+			case BREAK_LOOP:
+				/* No fall-through; a break ends up at the target of
+				   the SETUP_LOOP, which is followed from there */
+				continue;
+			case JUMP_ABSOLUTE:
+				com_pushdepth(depth, blocks, todo, &ntodo, queued,
+                              oparg, d, b);
+				continue;
+			case JUMP_FORWARD:
+				com_pushdepth(depth, blocks, todo, &ntodo, queued,
+                              next + oparg, d, b);
+				continue;
+			case JUMP_IF_FALSE:
+			case JUMP_IF_TRUE:
+				com_pushdepth(depth, blocks, todo, &ntodo, queued,
+                              next + oparg, d, b);
+				break;
+			case FOR_LOOP:
+				com_pushdepth(depth, blocks, todo, &ntodo, queued,
+                              next + oparg, d - 2, b);
+				break;
+			case SETUP_LOOP:
+				com_pushdepth(depth, blocks, todo, &ntodo, queued,
+                              next + oparg, d, b);
+				b++;
+				break;
+			case SETUP_EXCEPT:
+			case SETUP_FINALLY:
+				com_pushdepth(depth, blocks, todo, &ntodo, queued,
+                              next + oparg, d + 3, b);
+				b++;
+				break;
+			case POP_BLOCK:
+				b--;
+				break;
+		}
+		if (next < n) {
+			com_pushdepth(depth, blocks, todo, &ntodo, queued,
+                          next, d, b);
+        }
+	}
+	
+  done:
+	XDEL(depth);
+	XDEL(blocks);
+	XDEL(todo);
+	XDEL(queued);
+}
+
 /* Top-level compile-node interface */
 
 static void
@@ -1662,6 +2497,7 @@ compile_funcdef(struct compiling *c, node *n)
 	c->c_infunction = 0;
 	com_addoparg(c, LOAD_CONST, com_addconst(c, None));
 	com_addbyte(c, RETURN_VALUE);
+	com_optimize(c);
 }
 
 static void
@@ -1730,8 +2566,14 @@ compile(node *n, char *filename)
     }
 	compile_node(&sc, n);
 	com_done(&sc);
+	if (optimizeflag) {
+		com_peephole(&sc);
+    }
+	com_stackdepth(&sc);
 	if (sc.c_errors == 0) {
-		co = newcodeobject(sc.c_code, sc.c_consts, sc.c_names, filename);
+		co = newcodeobject(sc.c_code, sc.c_consts, sc.c_names,
+                           sc.c_varnames, sc.c_flags, sc.c_stacksize,
+                           sc.c_maxblocks, filename);
     }
 	else {
 		co = NULL;
@@ -13,21 +13,51 @@ extern "C" {
 /* An intermediate code fragment contains:
    - a string that encodes the instructions,
    - a list of the constants,
-   - and a list of the names used. */
+   - a list of the names used,
+   - and, for function bodies, a list of the local variable names.
+
+   In code compiled with CO_OPTIMIZED set, the local variables are kept in
+   an array of slots in the frame, indexed by position in co_varnames, and
+   the frame has no locals dictionary until one is asked for.
+
+   The name cache has an entry per name in co_names, where LOAD_NAME and
+   LOAD_GLOBAL remember what the name was found to be, and under which
+   versions of the locals, globals and builtins dictionaries (see ceval.c).
+   It is allocated when first used. */
+
+typedef struct {
+	object			*nc_value;		/* borrowed from one of the dicts */
+	unsigned long	nc_locals;		/* dict versions, 0 if not used */
+	unsigned long	nc_globals;
+	unsigned long	nc_builtins;
+} namecache;
 
 typedef struct {
 	OB_HEAD
 	stringobject 	*co_code;		/* instruction opcodes */
 	object 			*co_consts;		/* list of immutable constant objects */
 	object 			*co_names;		/* list of stringobjects */
+	object 			*co_varnames;	/* list of local variable names */
 	object 			*co_filename;	/* string */
+	int				co_flags;		/* CO_... flags, see below */
+	int				co_stacksize;	/* max depth of the value stack */
+	int				co_maxblocks;	/* max depth of the block stack */
+	namecache		*co_namecache;	/* NULL until LOAD_NAME or LOAD_GLOBAL */
 } codeobject;
 
+/* Masks for co_flags */
+#define CO_OPTIMIZED	0x0001	/* Locals use LOAD_FAST/STORE_FAST */
+#define CO_GENERATOR	0x0002	/* Contains 'yield'; calls make a generator */
+
 extern typeobject Codetype;
-#define is_codeobject(op) ((op)->ob_type == &Codetype)
+#define is_codeobject(op) (TYPEOF(op) == &Codetype)
 
 /* Public interface */
 codeobject *compile(struct _node *, char *);
+codeobject *newcodeobject(object *, object *, object *, object *, int, int,
+                          int, char *);
+
+extern int optimizeflag; /* Run the peephole optimizer (option -O) */
 
 #ifdef __cplusplus
 }
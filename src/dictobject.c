@@ -1,13 +1,15 @@
 /* Dictionary object implementation; using a hash table */
 
-/* XXX Note -- although this may look professional, I didn't think very hard
-   about the problem and it is possible that obvious improvements exist.
-   A similar module that I saw by Chris Torek:
-	   - uses chaining instead of hashed linear probing
-	   - remembers the hash value with the entry to speed up table resizing
-	   - sets the table size to a power of 2
-	   - uses a different hash function:
-		 h = 0; p = str; while (*p) h = (h << 5) - h + *p++; */
+/* The table is split in two parts.  The entries (hash, key and value) are
+   kept in a dense array, in order of insertion; the hash table proper is an
+   index of a power of 2 slots, each holding the position of an entry in that
+   array, or IX_EMPTY or IX_DUMMY.  The index is small, since its slots are
+   only as wide as needed to count the entries (one byte for small dicts),
+   and iterating over the keys only has to walk the dense array.
+
+   Lookups mask the hash instead of dividing by a prime table size; the
+   sequence of slots probed is perturbed by the higher bits of the hash, so
+   that keys whose hashes agree in their low bits soon go separate ways. */
 
 #include <string.h>
 
@@ -22,251 +24,367 @@
 #include "errors.h"
 #include "modsupport.h"
 
-/* Table of primes suitable as keys, in ascending order. The first line are the
-   largest primes less than some powers of two, the second line is the largest
-   prime less than 6000, and the third line is a selection from Knuth, Vol. 3,
-   Sec. 6.1, Table 1.  The final value is a sentinel and should cause the
-   memory allocation of that many entries to fail (if none of the earlier
-   values cause such failure already). */
-static unsigned int primes[] = {
-	3, 7, 13, 31, 61, 127, 251, 509, 1021, 2017, 4093,
-	5987,
-	9551, 15683, 19609, 31397,
-	0xffffffff /* All bits set -- truncation OK */
-};
+/* Index slot values other than entry positions.  A deleted key leaves a
+   dummy in its slot, since otherwise other keys may be lost, and a hole in
+   the entry array, with de_key and de_value set to NULL. */
+#define IX_EMPTY	(-1)
+#define IX_DUMMY	(-2)
+
+/* To ensure the lookup algorithm terminates, there must be at least one
+   empty slot in the index.  The number of entries, di_fill, which includes
+   the holes, is at most USABLE(di_size), two thirds of the index, so that
+   lookups on a near-full table aren't slowed down; when no entry is left, the
+   dictionary is resized, which also squeezes out the holes.  di_used is the
+   number of entries in use. */
+#define MINSIZE			8
+#define USABLE(size)	(((size) << 1) / 3)
+#define INDEXWIDTH(size) \
+	((size) <= 0x80 ? sizeof(signed char) \
+                    : (size) <= 0x8000 ? sizeof(short) : sizeof(int))
+
+/* Source of version numbers; 0 is never used, so it can mean "no version" */
+static unsigned long last_version;
+
+#define NEW_VERSION(dp) ((dp)->di_version = ++last_version)
 
-/* String used as dummy key to fill deleted entries */
-static stringobject *dummy; /* Initialized by first call to newdictobject() */
+static int
+getindex(register dictobject *dp, register int i)
+{
+	if (dp->di_size <= 0x80) {
+		return ((signed char *)dp->di_indices)[i];
+    }
+	else if (dp->di_size <= 0x8000) {
+		return ((short *)dp->di_indices)[i];
+    }
+	else {
+		return ((int *)dp->di_indices)[i];
+    }
+}
 
-/* Invariant for entries: when in use, de_value is not NULL and de_key is not
-   NULL and not dummy; when not in use, de_value is NULL and de_key is either
-   NULL or dummy.  A dummy key value cannot be replaced by NULL, since
-   otherwise other keys may be lost. */
-typedef struct {
-	stringobject 	*de_key;
-	object 			*de_value;
-} dictentry;
-
-/* To ensure the lookup algorithm terminates, the table size must be a prime
-   number and there must be at least one NULL key in the table. The value
-   di_fill is the number of non-NULL keys; di_used is the number of non-NULL,
-   non-dummy keys.  To avoid slowing down lookups on a near-full table, we
-   resize the table when it is more than half filled. */
-typedef struct {
-	OB_HEAD
-	int 		di_fill;
-	int 		di_used;
-	int 		di_size;
-	dictentry 	*di_table;
-} dictobject;
+static void
+setindex(register dictobject *dp, register int i, int ix)
+{
+	if (dp->di_size <= 0x80) {
+		((signed char *)dp->di_indices)[i] = ix;
+    }
+	else if (dp->di_size <= 0x8000) {
+		((short *)dp->di_indices)[i] = ix;
+    }
+	else {
+		((int *)dp->di_indices)[i] = ix;
+    }
+}
+
+/* Give the dictionary a new, empty table with size index slots.  The index
+   and the entries are allocated as one block, index first. */
+static int
+newtable(dictobject *dp, int size)
+{
+	int indexbytes = size * INDEXWIDTH(size);
+	char *p;
+
+	p = mem_malloc(indexbytes + USABLE(size) * sizeof(dictentry));
+	if (p == NULL) {
+		err_nomem();
+		return -1;
+	}
+	memset(p, 0xff, indexbytes); /* All slots IX_EMPTY, whatever the width */
+	dp->di_size = size;
+	dp->di_indices = p;
+	dp->di_entries = (dictentry *)(p + indexbytes);
+	dp->di_fill = 0;
+	dp->di_used = 0;
+	return 0;
+}
 
 object *
 newdictobject()
 {
 	register dictobject *dp;
 
-	if (dummy == NULL) { /* Auto-initialize dummy */
-		dummy = (stringobject *)newstringobject("");
-		if (dummy == NULL) {
-			return NULL;
-        }
-	}
 	dp = NEWOBJ(dictobject, &Dicttype);
 	if (dp == NULL) {
 		return NULL;
     }
-	dp->di_size = primes[0];
-	dp->di_table = (dictentry *)calloc(sizeof(dictentry), dp->di_size);
-	if (dp->di_table == NULL) {
+	if (newtable(dp, MINSIZE) != 0) {
 		DEL(dp);
-		return err_nomem();
+		return NULL;
 	}
-	dp->di_fill = 0;
-	dp->di_used = 0;
+	NEW_VERSION(dp);
 	return (object *)dp;
 }
 
-/* The basic lookup function used by all operations.  This is essentially
-   Algorithm D from Knuth Vol. 3, Sec. 6.4.  Open addressing is preferred over
-   chaining since the link overhead for chaining would be substantial (100%
-   with typical malloc overhead).
+/* The basic lookup functions used by all operations.  They return the index
+   slot for the key: the slot of its entry if it is there; otherwise the slot
+   where it should be inserted, which is either empty or the first dummy
+   passed (and then getindex() returns a negative value for it).
+
+   The hash value is computed by hashobject(); for a string key it comes
+   from hashsizedstring() (see stringobject.c) and is cached in the key
+   object.  It is also kept in the entry, so keys already in the table never
+   need to be rehashed, and keys with another hash are skipped without
+   looking at them.
+
+   The first slot probed is given by the low bits of the hash.  The next
+   one is computed from the previous one by i = 5*i + 1 + perturb, where
+   perturb starts as the hash and is shifted right by 5 bits on every probe;
+   once it is zero this visits every slot.
+
+   There are three flavors: lookdict() takes a C string and its hash, and is
+   used by the char * interface; lookdict2() takes a string object, and first
+   tries pointer identity and the cached hashes before comparing characters.
+   This is the one used by the interpreter for names from the code object.
+   lookdictobj() takes a key of any other type, and compares with
+   cmpobject(); objects of different types are never equal. */
 
-   First a 32-bit hash value, 'sum', is computed from the key string.  The
-   first character is added an extra time shifted by 8 to avoid hashing single
-   -character keys (often heavily used variables) too close together.  All
-   arithmetic on sum should ignore overflow.
+#define PERTURB_SHIFT 5
 
-   The initial probe index is then computed as sum mod the table size.
-   Subsequent probe indices are incr apart (mod table size), where incr is also
-   derived from sum, with the additional requirement that it is relative prime
-   to the table size (i.e., 1 <= incr < size, since the size is a prime
-   number).  My choice for incr is somewhat arbitrary. */
-static dictentry *
-lookdict(register dictobject *dp, char *key)
+static int
+lookdict(register dictobject *dp, char *key, long hash)
 {
-	register int i, incr;
-	register dictentry *freeslot = NULL;
-	register unsigned char *p = (unsigned char *)key;
-	register unsigned long sum = *p << 7;
+	register unsigned long perturb = (unsigned long)hash;
+	register int mask = dp->di_size - 1;
+	register int i = (int)(perturb & mask), ix, freeslot = -1;
+	register dictentry *ep;
+
+	for (;;) {
+		ix = getindex(dp, i);
+		if (ix == IX_EMPTY) {
+			return freeslot >= 0 ? freeslot : i;
+        }
+		if (ix == IX_DUMMY) {
+			if (freeslot < 0) {
+				freeslot = i;
+            }
+		}
+		else {
+			ep = &dp->di_entries[ix];
+			if (ep->de_hash == hash && is_stringobject(ep->de_key)
+                && (GETSTRINGVALUE((stringobject *)ep->de_key) == key
+                    || strcmp(GETSTRINGVALUE((stringobject *)ep->de_key),
+                              key) == 0))
+            {
+				return i;
+			}
+		}
+		perturb >>= PERTURB_SHIFT;
+		i = (int)((5 * (unsigned long)i + 1 + perturb) & mask);
+	}
+}
+
+static int
+lookdict2(register dictobject *dp, register stringobject *key)
+{
+	register long hash = GETSTRINGHASH(key);
+	register unsigned long perturb = (unsigned long)hash;
+	register int mask = dp->di_size - 1;
+	register int i = (int)(perturb & mask), ix, freeslot = -1;
+	register dictentry *ep;
 
-	while (*p != '\0') {
-		sum = sum + sum + *p++;
-    }
-	i = sum % dp->di_size;
-	do {
-		sum = sum + sum + 1;
-		incr = sum % dp->di_size;
-	} while (incr == 0);
 	for (;;) {
-		register dictentry *ep = &dp->di_table[i];
-		if (ep->de_key == NULL) {
-			if (freeslot != NULL) {
-				return freeslot;
+		ix = getindex(dp, i);
+		if (ix == IX_EMPTY) {
+			return freeslot >= 0 ? freeslot : i;
+        }
+		if (ix == IX_DUMMY) {
+			if (freeslot < 0) {
+				freeslot = i;
             }
-			else {
-				return ep;
+		}
+		else {
+			ep = &dp->di_entries[ix];
+			if (ep->de_key == (object *)key) {
+				return i;
             }
+			if (ep->de_hash == hash && is_stringobject(ep->de_key)
+                && ((stringobject *)ep->de_key)->ob_size == key->ob_size
+                && memcmp(GETSTRINGVALUE((stringobject *)ep->de_key),
+                          GETSTRINGVALUE(key), (int)key->ob_size) == 0)
+            {
+				return i;
+			}
 		}
-		if (ep->de_key == dummy) {
-			if (freeslot != NULL) {
-				freeslot = ep;
+		perturb >>= PERTURB_SHIFT;
+		i = (int)((5 * (unsigned long)i + 1 + perturb) & mask);
+	}
+}
+
+static int
+lookdictobj(register dictobject *dp, object *key, long hash)
+{
+	register unsigned long perturb = (unsigned long)hash;
+	register int mask = dp->di_size - 1;
+	register int i = (int)(perturb & mask), ix, freeslot = -1;
+	register dictentry *ep;
+
+	for (;;) {
+		ix = getindex(dp, i);
+		if (ix == IX_EMPTY) {
+			return freeslot >= 0 ? freeslot : i;
+        }
+		if (ix == IX_DUMMY) {
+			if (freeslot < 0) {
+				freeslot = i;
             }
 		}
-		else if (GETSTRINGVALUE(ep->de_key)[0] == key[0]) {
-			if (strcmp(GETSTRINGVALUE(ep->de_key), key) == 0) {
-				return ep;
+		else {
+			ep = &dp->di_entries[ix];
+			if (ep->de_key == key
+                || (ep->de_hash == hash && TYPEOF(ep->de_key) == TYPEOF(key)
+                    && cmpobject(ep->de_key, key) == 0))
+            {
+				return i;
 			}
 		}
-		i = (i + incr) % dp->di_size;
+		perturb >>= PERTURB_SHIFT;
+		i = (int)((5 * (unsigned long)i + 1 + perturb) & mask);
 	}
 }
 
-/* Internal routine to insert a new item into the table.  Used both by the
-   internal resize routine and by the public insert routine. Eats a reference
-   to key and one to value. */
+/* Find the slot for key, whose hash is known; for strings it is cached */
+#define LOOKDICT2(dp, key, hash) \
+	(is_stringobject(key) ? lookdict2((dp), (stringobject *)(key)) \
+                          : lookdictobj((dp), (key), (hash)))
+
+/* Return the hash of a key, or -1 with an error set if it has none */
+#define HASHKEY(key) \
+	(is_stringobject(key) ? GETSTRINGHASH((stringobject *)(key)) \
+                          : hashobject(key))
+
+/* Return the entry in index slot i, or NULL if the slot holds none */
+#define SLOTENTRY(dp, i) \
+	(getindex((dp), (i)) >= 0 ? &(dp)->di_entries[getindex((dp), (i))] \
+                              : (dictentry *)NULL)
+
+/* Internal routine to insert a new item into the table.  The caller must
+   make sure there is room for one more entry.  Eats a reference to key and
+   one to value. */
 static void
-insertdict(register dictobject *dp, stringobject *key, object *value)
+insertdict(register dictobject *dp, object *key, long hash, object *value)
 {
-	register dictentry *ep = lookdict(dp, GETSTRINGVALUE(key));
-
-	if (ep->de_value != NULL) {
-		DECREF(ep->de_value);
+	register int i = LOOKDICT2(dp, key, hash);
+	register dictentry *ep = SLOTENTRY(dp, i);
+	object *old;
+
+	NEW_VERSION(dp);
+	if (ep != NULL) {
+		old = ep->de_value;
+		ep->de_value = value;
+		DECREF(old);
 		DECREF(key);
 	}
 	else {
-		if (ep->de_key == NULL) {
-			dp->di_fill++;
-        }
-		else {
-			DECREF(ep->de_key);
-        }
+		ep = &dp->di_entries[dp->di_fill];
+		ep->de_hash = hash;
 		ep->de_key = key;
+		ep->de_value = value;
+		setindex(dp, i, dp->di_fill);
+		dp->di_fill++;
 		dp->di_used++;
 	}
-	ep->de_value = value;
 }
 
-/* Restructure the table by allocating a new table and reinserting all items
-   again.  When entries have been deleted, the new table may actually be
-   smaller than the old one. */
+/* Restructure the table by allocating a new one with room for minused entries
+   and moving the entries in use over, in the same order.  When entries have
+   been deleted, the new table may actually be smaller than the old one. */
 static int
-dictresize(dictobject *dp)
+dictresize(dictobject *dp, int minused)
 {
-	register int oldsize = dp->di_size, newsize = dp->di_size, i;
-	register dictentry *oldtable = dp->di_table, *newtable, *ep;
-
-	for (i = 0; ; i++) {
-		if (primes[i] > dp->di_used * 2) {
-			newsize = primes[i];
-			break;
-		}
-	}
-	newtable = (dictentry *)calloc(sizeof(dictentry), newsize);
-	if (newtable == NULL) {
-		err_nomem();
-		return -1;
-	}
-	dp->di_size = newsize;
-	dp->di_table = newtable;
-	dp->di_fill = 0;
-	dp->di_used = 0;
-	for (i = 0, ep = oldtable; i < oldsize; i++, ep++) {
-		if (ep->de_value != NULL) {
-			insertdict(dp, ep->de_key, ep->de_value);
-        }
-		else if (ep->de_key != NULL) {
-			DECREF(ep->de_key);
+	char *oldindices = dp->di_indices;
+	dictentry *oldentries = dp->di_entries, *ep;
+	int oldfill = dp->di_fill;
+	int newsize, mask, i, j;
+	unsigned long perturb;
+
+	for (newsize = MINSIZE; USABLE(newsize) <= minused; newsize <<= 1)
+		;
+	if (newtable(dp, newsize) != 0) {
+		return -1; /* The old table is left alone */
+    }
+	mask = newsize - 1;
+	for (j = 0, ep = oldentries; j < oldfill; j++, ep++) {
+		if (ep->de_value == NULL) {
+			continue;
         }
+		/* No need to compare keys: they are all different */
+		perturb = (unsigned long)ep->de_hash;
+		for (i = (int)(perturb & mask); getindex(dp, i) != IX_EMPTY;) {
+			perturb >>= PERTURB_SHIFT;
+			i = (int)((5 * (unsigned long)i + 1 + perturb) & mask);
+		}
+		setindex(dp, i, dp->di_fill);
+		dp->di_entries[dp->di_fill++] = *ep;
 	}
-	DEL(oldtable);
+	dp->di_used = dp->di_fill;
+	DEL(oldindices);
 	return 0;
 }
 
 object *
 dictlookup(object *op, char *key)
 {
+	dictobject *dp = (dictobject *)op;
+	dictentry *ep;
+
 	if (!is_dictobject(op)) {
 		fatal("dictlookup on non-dictionary");
     }
-	return lookdict((dictobject *)op, key)->de_value;
+	ep = SLOTENTRY(dp, lookdict(dp, key, hashsizedstring(key, (int)strlen(key))));
+	return ep == NULL ? NULL : ep->de_value;
 }
 
-#ifdef NOT_USED
-static object *
-dict2lookup(register object *op, register object *key)
+object *
+dict2lookup(object *op, object *key)
 {
-	register object *res;
+	dictobject *dp = (dictobject *)op;
+	dictentry *ep;
+	long hash;
 
 	if (!is_dictobject(op)) {
-		err_badcall();
-		return NULL;
-	}
-	if (!is_stringobject(key)) {
-		err_badarg();
-		return NULL;
-	}
-	res = lookdict((dictobject *)op, ((stringobject *)key)->ob_sval)->de_value;
-	if (res == NULL) {
-		err_setstr(KeyError, "key not in dictionary");
+		fatal("dict2lookup on non-dictionary");
     }
-	return res;
+	if (is_stringobject(key)) {
+		ep = SLOTENTRY(dp, lookdict2(dp, (stringobject *)key));
+    }
+	else {
+		if ((hash = hashobject(key)) == -1) {
+			return NULL;
+        }
+		ep = SLOTENTRY(dp, lookdictobj(dp, key, hash));
+	}
+	return ep == NULL ? NULL : ep->de_value;
 }
-#endif
 
-static int
+int
 dict2insert(register object *op, object *key, object *value)
 {
 	register dictobject *dp;
-	register stringobject *keyobj;
+	long hash;
 
 	if (!is_dictobject(op)) {
 		err_badcall();
 		return -1;
 	}
 	dp = (dictobject *)op;
-	if (!is_stringobject(key)) {
-		err_badarg();
+	if ((hash = HASHKEY(key)) == -1) {
 		return -1;
+    }
+	/* if no entry is left, resize, leaving room to double the dict */
+	if (dp->di_fill >= USABLE(dp->di_size)) {
+		if (dictresize(dp, 2 * dp->di_used + 1) != 0) {
+			return -1;
+        }
 	}
-	keyobj = (stringobject *)key;
-	/* if fill >= 2/3 size, resize */
-	if (dp->di_fill * 3 >= dp->di_size * 2) {
-		if (dictresize(dp) != 0) {
-			if (dp->di_fill + 1 > dp->di_size) {
-				return -1;
-            }
-		}
-	}
-	INCREF(keyobj);
+	INCREF(key);
 	INCREF(value);
-	insertdict(dp, keyobj, value);
+	insertdict(dp, key, hash, value);
 	return 0;
 }
 
 int
 dictinsert(object *op, char *key, object *value)
 {
-	register object *keyobj = newstringobject(key);
+	register object *keyobj = internstring(key);
 	register int err;
 
 	if (keyobj == NULL) {
@@ -278,41 +396,58 @@ dictinsert(object *op, char *key, object *value)
 	return err;
 }
 
-int
-dictremove(object *op, char *key)
+/* Delete the entry in index slot i, if there is one */
+static int
+deleteslot(dictobject *dp, int i)
 {
-	register dictobject *dp;
-	register dictentry *ep;
+	dictentry *ep = SLOTENTRY(dp, i);
+	object *key, *value;
 
-	if (!is_dictobject(op)) {
-		err_badcall();
-		return -1;
-	}
-	dp = (dictobject *)op;
-	ep = lookdict(dp, key);
-	if (ep->de_value == NULL) {
+	if (ep == NULL) {
 		err_setstr(KeyError, "key not in dictionary");
 		return -1;
 	}
-	DECREF(ep->de_key);
-	INCREF(dummy);
-	ep->de_key = dummy;
-	DECREF(ep->de_value);
+	NEW_VERSION(dp);
+	setindex(dp, i, IX_DUMMY);
+	key = ep->de_key;
+	value = ep->de_value;
+	ep->de_key = NULL;
 	ep->de_value = NULL;
 	dp->di_used--;
+	DECREF(key);
+	DECREF(value);
 	return 0;
 }
 
-static int
+int
+dictremove(object *op, char *key)
+{
+	if (!is_dictobject(op)) {
+		err_badcall();
+		return -1;
+	}
+	return deleteslot((dictobject *)op,
+                      lookdict((dictobject *)op, key,
+                               hashsizedstring(key, (int)strlen(key))));
+}
+
+int
 dict2remove(object *op, register object *key)
 {
-	if (!is_stringobject(key)) {
-		err_badarg();
+	long hash;
+
+	if (!is_dictobject(op)) {
+		err_badcall();
 		return -1;
 	}
-	return dictremove(op, GETSTRINGVALUE((stringobject *)key));
+	if ((hash = HASHKEY(key)) == -1) {
+		return -1;
+    }
+	return deleteslot((dictobject *)op, LOOKDICT2((dictobject *)op, key, hash));
 }
 
+/* For iteration: keys are numbered 0 to getdictsize() - 1, with holes where
+   getdictkey() returns NULL.  Deleting keys doesn't renumber the others. */
 int
 getdictsize(register object *op)
 {
@@ -320,7 +455,7 @@ getdictsize(register object *op)
 		err_badcall();
 		return -1;
 	}
-	return ((dictobject *)op)->di_size;
+	return ((dictobject *)op)->di_fill;
 }
 
 static object *
@@ -335,15 +470,12 @@ getdict2key(object *op, register int i)
 		return NULL;
 	}
 	dp = (dictobject *)op;
-	if (i < 0 || i >= dp->di_size) {
+	if (i < 0 || i >= dp->di_fill) {
 		/* err_badarg(); */
 		return NULL;
 	}
-	if (dp->di_table[i].de_value == NULL) {
-		/* Not an error! */
-		return NULL;
-	}
-	return (object *)dp->di_table[i].de_key;
+	/* A hole is not an error! */
+	return dp->di_entries[i].de_key;
 }
 
 char *
@@ -351,7 +483,7 @@ getdictkey(object *op, int i)
 {
 	register object *keyobj = getdict2key(op, i);
 
-	if (keyobj == NULL) {
+	if (keyobj == NULL || !is_stringobject(keyobj)) {
 		return NULL;
     }
 	return GETSTRINGVALUE((stringobject *)keyobj);
@@ -365,7 +497,7 @@ dict_dealloc(register dictobject *dp)
 	register int i;
 	register dictentry *ep;
 
-	for (i = 0, ep = dp->di_table; i < dp->di_size; i++, ep++) {
+	for (i = 0, ep = dp->di_entries; i < dp->di_fill; i++, ep++) {
 		if (ep->de_key != NULL) {
 			DECREF(ep->de_key);
         }
@@ -373,9 +505,7 @@ dict_dealloc(register dictobject *dp)
 			DECREF(ep->de_value);
         }
 	}
-	if (dp->di_table != NULL) {
-		DEL(dp->di_table);
-    }
+	DEL(dp->di_indices);
 	DEL(dp);
 }
 
@@ -386,7 +516,7 @@ dict_print(register dictobject *dp, register FILE *fp, register int flags)
 	register dictentry *ep;
 
 	fprintf(fp, "{");
-	for (i = 0, ep = dp->di_table; i < dp->di_size && !StopPrint; i++, ep++) {
+	for (i = 0, ep = dp->di_entries; i < dp->di_fill && !StopPrint; i++, ep++) {
 		if (ep->de_value != NULL) {
 			if (any++ > 0) {
 				fprintf(fp, "; ");
@@ -399,42 +529,29 @@ dict_print(register dictobject *dp, register FILE *fp, register int flags)
 	fprintf(fp, "}");
 }
 
-static void
-js(object **pv, object *w)
-{
-	joinstring(pv, w);
-	if (w != NULL) {
-		DECREF(w);
-    }
-}
-
 static object *
 dict_repr(dictobject *dp)
 {
-	auto object *v = newstringobject("{");
-	register object *w;
-	object *semi = newstringobject("; "), *colon = newstringobject(": ");
+	stringbuilder sb;
 	register int i, any = 0;
 	register dictentry *ep;
 
-	for (i = 0, ep = dp->di_table; i < dp->di_size && !StopPrint; i++, ep++) {
+	sb_init(&sb, 2 + 8 * dp->di_used);
+	sb_addchars(&sb, "{", 1);
+	for (i = 0, ep = dp->di_entries; i < dp->di_fill && !StopPrint; i++, ep++) {
 		if (ep->de_value != NULL) {
 			if (any++) {
-				joinstring(&v, semi);
+				sb_addchars(&sb, "; ", 2);
+            }
+			sb_addrepr(&sb, (object *)ep->de_key);
+			sb_addchars(&sb, ": ", 2);
+			if (sb_addrepr(&sb, ep->de_value) != 0) {
+				break;
             }
-			js(&v, w = reprobject((object *)ep->de_key));
-			joinstring(&v, colon);
-			js(&v, w = reprobject(ep->de_value));
 		}
 	}
-	js(&v, w = newstringobject("}"));
-	if (semi != NULL) {
-		DECREF(semi);
-    }
-	if (colon != NULL) {
-		DECREF(colon);
-    }
-	return v;
+	sb_addchars(&sb, "}", 1);
+	return sb_finish(&sb);
 }
 
 static int
@@ -446,17 +563,19 @@ dict_length(dictobject *dp)
 static object *
 dict_subscript(dictobject *dp, register object *v)
 {
-	if (!is_stringobject(v)) {
-		err_badarg();
+	register dictentry *ep;
+	long hash;
+
+	if ((hash = HASHKEY(v)) == -1) {
 		return NULL;
-	}
-	v = lookdict(dp, GETSTRINGVALUE((stringobject *)v))->de_value;
-	if (v == NULL) {
-		err_setstr(KeyError, "key not in dictionary");
-    }
-	else {
-		INCREF(v);
     }
+	ep = SLOTENTRY(dp, LOOKDICT2(dp, v, hash));
+	if (ep == NULL) {
+		err_setstr(KeyError, "key not in dictionary");
+		return NULL;
+	}
+	v = ep->de_value;
+	INCREF(v);
 	return v;
 }
 
@@ -490,11 +609,11 @@ dict_keys(register dictobject *dp, object *args)
 	if (v == NULL) {
 		return NULL;
     }
-	for (i = 0, j = 0; i < dp->di_size; i++) {
-		if (dp->di_table[i].de_value != NULL) {
-			stringobject *key = dp->di_table[i].de_key;
+	for (i = 0, j = 0; i < dp->di_fill; i++) {
+		if (dp->di_entries[i].de_value != NULL) {
+			object *key = dp->di_entries[i].de_key;
 			INCREF(key);
-			setlistitem(v, j, (object *)key);
+			setlistitem(v, j, key);
 			j++;
 		}
 	}
@@ -514,13 +633,17 @@ getdictkeys(object *dp)
 static object *
 dict_has_key(register dictobject *dp, object *args)
 {
-	object *key;
 	register long ok;
+	long hash;
 
-	if (!getstrarg(args, &key)) {
+	if (args == NULL) {
+		err_badarg();
+		return NULL;
+	}
+	if ((hash = HASHKEY(args)) == -1) {
 		return NULL;
     }
-	ok = lookdict(dp, GETSTRINGVALUE((stringobject *)key))->de_value != NULL;
+	ok = getindex(dp, LOOKDICT2(dp, args, hash)) >= 0;
 	return newintobject(ok);
 }
 
@@ -536,6 +659,93 @@ dict_getattr(dictobject *dp, char *name)
 	return findmethod(dict_methods, (object *)dp, name);
 }
 
+/* Dictionary iterators give the keys, walking the entry array like
+   dict_keys(); adding or removing keys while that goes on would make it
+   skip or repeat some, so it is an error */
+
+typedef struct {
+	OB_HEAD
+	dictobject *it_dict;	/* NULL once the end has been reached */
+	int it_pos;				/* index in di_entries */
+	int it_used;			/* di_used of the dictionary when started */
+} dictiterobject;
+
+static void
+dictiter_dealloc(dictiterobject *it)
+{
+	XDECREF(it->it_dict);
+	DEL(it);
+}
+
+static object *
+dictiter_iter(dictiterobject *it)
+{
+	INCREF(it);
+	return (object *)it;
+}
+
+static object *
+dictiter_next(dictiterobject *it)
+{
+	dictobject *dp = it->it_dict;
+	object *key;
+
+	if (dp == NULL) {
+		return NULL;
+    }
+	if (dp->di_used != it->it_used) {
+		err_setstr(RuntimeError, "dictionary changed size during iteration");
+		return NULL;
+	}
+	while (it->it_pos < dp->di_fill) {
+		dictentry *ep = &dp->di_entries[it->it_pos++];
+		if (ep->de_value != NULL) {
+			key = ep->de_key;
+			INCREF(key);
+			return key;
+		}
+	}
+	it->it_dict = NULL;
+	DECREF(dp);
+	return NULL;
+}
+
+static typeobject Dictitertype = {
+	OB_HEAD_INIT(&Typetype)
+	0,
+	"dictionary-keyiterator",
+	sizeof(dictiterobject),
+	0,
+	(destructor)dictiter_dealloc,	/*tp_dealloc*/
+	0,								/*tp_print*/
+	0,								/*tp_getattr*/
+	0,								/*tp_setattr*/
+	0,								/*tp_compare*/
+	0,								/*tp_repr*/
+	0,								/*tp_as_number*/
+	0,								/*tp_as_sequence*/
+	0,								/*tp_as_mapping*/
+	0,								/*tp_hash*/
+	0,								/*tp_methods*/
+	(getiterfunc)dictiter_iter,		/*tp_iter*/
+	(iternextfunc)dictiter_next,	/*tp_iternext*/
+};
+
+static object *
+dict_iter(dictobject *dp)
+{
+	dictiterobject *it = NEWOBJ(dictiterobject, &Dictitertype);
+
+	if (it == NULL) {
+		return NULL;
+    }
+	INCREF(dp);
+	it->it_dict = dp;
+	it->it_pos = 0;
+	it->it_used = dp->di_used;
+	return (object *)it;
+}
+
 typeobject Dicttype = {
 	OB_HEAD_INIT(&Typetype)
 	0,
@@ -551,4 +761,7 @@ typeobject Dicttype = {
 	0,							/*tp_as_number*/
 	0,							/*tp_as_sequence*/
 	&dict_as_mapping,			/*tp_as_mapping*/
+	0,							/*tp_hash*/
+	dict_methods,				/*tp_methods*/
+	(getiterfunc)dict_iter,		/*tp_iter*/
 };
@@ -5,14 +5,46 @@
 extern "C" {
 #endif
 
-/* Dictionary object type -- mapping from char * to object.  NB: the key is
-given as a char *, not as a stringobject.  These functions set errno for
-errors.  Functions dictremove() and dictinsert() return nonzero for errors,
-getdictsize() returns -1, the others NULL.  A successful call to dictinsert()
-calls INCREF() for the inserted item. */
+#include "stringobject.h"
+
+/* Dictionary object type -- mapping from hashable objects to objects.  Keys
+are usually strings, and the basic interface takes them as a char *, not as a
+stringobject.  These functions set errno for errors.  Functions dictremove()
+and dictinsert() return nonzero for errors, getdictsize() returns -1, the
+others NULL.  A successful call to dictinsert() calls INCREF() for the
+inserted item.  getdictkey() returns NULL for a key that isn't a string. */
+
+typedef struct {
+	long			de_hash;		/* cached hash of de_key */
+	object 			*de_key;
+	object 			*de_value;
+} dictentry;
+
+/* Every dictionary gets a new version number, unique among all dictionaries,
+when it is created and whenever an item is inserted, replaced or removed.  As
+long as the version is the same, the contents are the same, so the result of
+a lookup may be remembered and reused by comparing versions (see ceval.c). */
+
+/* The entries are kept in insertion order in di_entries, which may have holes
+left by deleted items; di_indices is a hash table of di_size slots (a power of
+2) holding positions in di_entries.  Both live in a single block starting at
+di_indices.  See dictobject.c for the details. */
+
+typedef struct {
+	OB_HEAD
+	int 			di_fill;		/* # entries taken, including holes */
+	int 			di_used;		/* # entries in use */
+	int 			di_size;		/* # index slots */
+	char 			*di_indices;
+	dictentry 		*di_entries;
+	unsigned long	di_version;
+} dictobject;
 
 extern typeobject Dicttype;
-#define is_dictobject(op) ((op)->ob_type == &Dicttype)
+#define is_dictobject(op) (TYPEOF(op) == &Dicttype)
+
+/* Macro, trading safety for speed */
+#define GETDICTVERSION(op) (((dictobject *)(op))->di_version)
 
 extern object    *newdictobject(void);
 extern object    *dictlookup(object *dp, char *key);
@@ -22,6 +54,16 @@ extern int       getdictsize(object *dp);
 extern char      *getdictkey(object *dp, int i);
 extern object    *getdictkeys(object *dp);
 
+/* Variants taking the key as an object, of any type with a hash function
+(see hashobject()).  For string keys these use the hash cached in the key
+object, and are preferred where the key is already a stringobject.
+dict2lookup() sets no error when the key is not there; if the key can't be
+hashed, it returns NULL with an error set. */
+
+extern object    *dict2lookup(object *dp, object *key);
+extern int       dict2insert(object *dp, object *key, object *item);
+extern int       dict2remove(object *dp, object *key);
+
 #ifdef __cplusplus
 }
 #endif
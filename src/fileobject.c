@@ -89,7 +89,7 @@ file_dealloc(fileobject *f)
 	if (f->f_mode != NULL) {
 		DECREF(f->f_mode);
     }
-	free((char *)f);
+	DEL(f);
 }
 
 static void
@@ -242,6 +242,27 @@ file_getattr(fileobject *f, char *name)
 	return findmethod(file_methods, (object *)f, name);
 }
 
+/* A file is its own iterator, over its lines as readline() reads them */
+
+static object *
+file_iter(fileobject *f)
+{
+	INCREF(f);
+	return (object *)f;
+}
+
+static object *
+file_iternext(fileobject *f)
+{
+	object *v = file_readline(f, (object *)NULL);
+
+	if (v != NULL && getstringsize(v) == 0) {
+		DECREF(v);
+		return NULL;
+	}
+	return v;
+}
+
 typeobject Filetype = {
 	OB_HEAD_INIT(&Typetype)
 	0,
@@ -254,4 +275,11 @@ typeobject Filetype = {
 	0,							/*tp_setattr*/
 	0,							/*tp_compare*/
 	(reprfunc)file_repr,		/*tp_repr*/
+	0,							/*tp_as_number*/
+	0,							/*tp_as_sequence*/
+	0,							/*tp_as_mapping*/
+	0,							/*tp_hash*/
+	file_methods,				/*tp_methods*/
+	(getiterfunc)file_iter,		/*tp_iter*/
+	(iternextfunc)file_iternext,	/*tp_iternext*/
 };
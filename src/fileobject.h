@@ -8,7 +8,7 @@ extern "C" {
 /* File object interface */
 
 extern typeobject Filetype;
-#define is_fileobject(op) ((op)->ob_type == &Filetype)
+#define is_fileobject(op) (TYPEOF(op) == &Filetype)
 
 extern object *newfileobject(char *, char *);
 extern object *newopenfileobject(FILE *, char *, char *);
@@ -16,13 +16,25 @@ extern int errno;
 #include "errors.h"
 #include "malloc.h"
 
+/* Like ints, floats are created and freed all the time, so freed floats are
+   kept for reuse on a free list, linked through their first word.  Unlike
+   the ints' list it is bounded, and clearfloatfreelist() empties it. */
+
+#define MAXFREEFLOATS 1000
+
+static floatobject *free_list = NULL;
+static int numfree = 0;
+
 object *
 newfloatobject(double fval)
 {
-	/* For efficiency, this code is copied from newobject() */
-	register floatobject *op = (floatobject *)malloc(sizeof(floatobject));
+	register floatobject *op = free_list;
 
-	if (op == NULL) {
+	if (op != NULL) {
+		free_list = *(floatobject **)op;
+		numfree--;
+	}
+	else if ((op = (floatobject *)mem_malloc(sizeof(floatobject))) == NULL) {
 		return err_nomem();
     }
 	NEWREF(op);
@@ -34,7 +46,28 @@ newfloatobject(double fval)
 void
 float_dealloc(floatobject *op)
 {
-	DEL(op);
+	if (numfree < MAXFREEFLOATS) {
+		*(floatobject **)op = free_list;
+		free_list = op;
+		numfree++;
+	}
+	else {
+		DEL(op);
+    }
+}
+
+int
+clearfloatfreelist(void)
+{
+	int n = numfree;
+	floatobject *op;
+
+	while ((op = free_list) != NULL) {
+		free_list = *(floatobject **)op;
+		DEL(op);
+	}
+	numfree = 0;
+	return n;
 }
 
 double
@@ -106,6 +139,30 @@ float_compare(floatobject *v, floatobject *w)
 	return (i < j) ? -1 : (i > j) ? 1 : 0;
 }
 
+/* Floats that compare equal hash the same (0.0 and -0.0 too): the hash is
+   built from the normalized fraction and the exponent. */
+static long
+float_hash(floatobject *v)
+{
+	double x;
+	long hipart, h;
+	int expo;
+
+	/* frexp() returns these unchanged, and they don't convert to long */
+	if (isnan(v->ob_fval)) {
+		return 0;
+    }
+	if (isinf(v->ob_fval)) {
+		return v->ob_fval > 0 ? 314159 : -314159;
+    }
+	x = frexp(v->ob_fval, &expo);
+	x *= 2147483648.0; /* 2**31 */
+	hipart = (long)x;
+	x = (x - (double)hipart) * 2147483648.0;
+	h = hipart + (long)x + (long)((unsigned long)expo << 15);
+	return h == -1 ? -2 : h;
+}
+
 static object *
 float_add(floatobject *v, object *w)
 {
@@ -229,6 +286,7 @@ typeobject Floattype = {
 	&float_as_number,			/*tp_as_number*/
 	0,							/*tp_as_sequence*/
 	0,							/*tp_as_mapping*/
+	(hashfunc)float_hash,		/*tp_hash*/
 };
 
 /* XXX This is not enough.  Need:
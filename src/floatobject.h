@@ -14,11 +14,14 @@ typedef struct {
 } floatobject;
 
 extern typeobject Floattype;
-#define is_floatobject(op) ((op)->ob_type == &Floattype)
+#define is_floatobject(op) (TYPEOF(op) == &Floattype)
 
 extern object *newfloatobject(double);
 extern double getfloatvalue(object *);
 
+/* Free the floats kept for reuse; returns how many there were */
+extern int clearfloatfreelist(void);
+
 /* Macro, trading safety for speed */
 #define GETFLOATVALUE(op) ((op)->ob_fval)
 
@@ -2,9 +2,11 @@
 
 #include <stdio.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "object.h"
 #include "objimpl.h"
+#include "listobject.h"
 #include "dictobject.h"
 #include "errors.h"
 #include "malloc.h"
@@ -25,19 +27,62 @@ static struct memberlist frame_memberlist[] = {
 static object *
 frame_getattr(frameobject *f, char *name)
 {
+	if (strcmp(name, "f_locals") == 0) {
+		fast2locals(f);
+    }
 	return getmember((char *)f, frame_memberlist, name);
 }
 
+/* A frame is allocated as one piece of memory: the frameobject is followed
+   by the local variable slots, the value stack and the block stack.  Freed
+   frames are kept on a free list, linked through f_back, and are reused;
+   a recycled frame is grown with realloc() if it is too small.  The list is
+   bounded, so that a deep recursion doesn't keep its frames allocated for
+   good, and clearframefreelist() empties it. */
+
+#define MAXFREEFRAMES 200
+
+static frameobject *free_list = NULL;
+static int numfree = 0;
+
 static void
 frame_dealloc(frameobject *f)
 {
+	for (int i = 0; i < f->f_nlocals; i++) {
+		XDECREF(f->f_fastlocals[i]);
+    }
+	/* A suspended generator's frame still holds its value stack */
+	if (f->f_stacktop != NULL) {
+		for (object **p = f->f_valuestack; p < f->f_stacktop; p++) {
+			XDECREF(*p);
+        }
+	}
 	XDECREF(f->f_back);
 	XDECREF(f->f_code);
 	XDECREF(f->f_globals);
 	XDECREF(f->f_locals);
-	XDEL(f->f_valuestack);
-	XDEL(f->f_blockstack);
-	DEL(f);
+	if (numfree < MAXFREEFRAMES) {
+		f->f_back = free_list;
+		free_list = f;
+		numfree++;
+	}
+	else {
+		DEL(f);
+    }
+}
+
+int
+clearframefreelist(void)
+{
+	int n = numfree;
+	frameobject *f;
+
+	while ((f = free_list) != NULL) {
+		free_list = f->f_back;
+		DEL(f);
+	}
+	numfree = 0;
+	return n;
 }
 
 typeobject Frametype = {
@@ -62,38 +107,67 @@ newframeobject(frameobject *back, codeobject *code, object *globals,
                object *locals, int nvalues, int nblocks)
 {
 	frameobject *f;
+	int nlocals, extras;
 
 	if ((back != NULL && !is_frameobject(back)) || code == NULL
         || !is_codeobject(code) || globals == NULL || !is_dictobject(globals)
-        || locals == NULL || !is_dictobject(locals) || nvalues < 0
+        || (locals == NULL && !(code->co_flags & CO_OPTIMIZED))
+        || (locals != NULL && !is_dictobject(locals)) || nvalues < 0
         || nblocks < 0)
     {
 		err_badcall();
 		return NULL;
 	}
-	f = NEWOBJ(frameobject, &Frametype);
-	if (f != NULL) {
-		if (back) {
-			INCREF(back);
+	nlocals = getlistsize(code->co_varnames);
+	extras = (nlocals + nvalues + 1) * sizeof(object *)
+             + (nblocks + 1) * sizeof(block);
+	if (free_list == NULL) {
+		f = (frameobject *)mem_malloc(sizeof(frameobject) + extras);
+		if (f == NULL) {
+			return (frameobject *)err_nomem();
         }
-		f->f_back = back;
-		INCREF(code);
-		f->f_code = code;
-		INCREF(globals);
-		f->f_globals = globals;
-		INCREF(locals);
-		f->f_locals = locals;
-		f->f_valuestack = NEW(object *, nvalues + 1);
-		f->f_blockstack = NEW(block, nblocks + 1);
-		f->f_nvalues = nvalues;
-		f->f_nblocks = nblocks;
-		f->f_iblock = 0;
-		if (f->f_valuestack == NULL || f->f_blockstack == NULL) {
-			err_nomem();
-			DECREF(f);
-			f = NULL;
+		f->f_allocated = extras;
+	}
+	else {
+		f = free_list;
+		free_list = f->f_back;
+		numfree--;
+		if (f->f_allocated < extras) {
+			frameobject *g = (frameobject *)
+				mem_realloc((char *)f, sizeof(frameobject) + extras);
+			if (g == NULL) {
+				DEL(f);
+				return (frameobject *)err_nomem();
+			}
+			f = g;
+			f->f_allocated = extras;
 		}
 	}
+	NEWREF(f);
+	f->ob_type = &Frametype;
+	if (back) {
+		INCREF(back);
+    }
+	f->f_back = back;
+	INCREF(code);
+	f->f_code = code;
+	INCREF(globals);
+	f->f_globals = globals;
+	XINCREF(locals);
+	f->f_locals = locals;
+	f->f_fastlocals = (object **)(f + 1);
+	f->f_valuestack = f->f_fastlocals + nlocals;
+	f->f_blockstack = (block *)(f->f_valuestack + nvalues + 1);
+	f->f_nlocals = nlocals;
+	f->f_nvalues = nvalues;
+	f->f_nblocks = nblocks;
+	f->f_iblock = 0;
+	f->f_stacktop = f->f_valuestack;
+	f->f_lasti = 0;
+	f->f_lineno = -1;
+	for (int i = 0; i < nlocals; i++) {
+		f->f_fastlocals[i] = NULL;
+    }
 	return f;
 }
 
@@ -126,3 +200,52 @@ pop_block(frameobject *f)
 	b = &f->f_blockstack[--f->f_iblock];
 	return b;
 }
+
+/* Local variable slots */
+
+void
+fast2locals(frameobject *f)
+{
+	object *name, *value;
+
+	if (!(f->f_code->co_flags & CO_OPTIMIZED)) {
+		return;
+    }
+	if (f->f_locals == NULL) {
+		if ((f->f_locals = newdictobject()) == NULL) {
+			err_clear();
+			return;
+		}
+	}
+	for (int i = 0; i < f->f_nlocals; i++) {
+		name = getlistitem(f->f_code->co_varnames, i);
+		value = f->f_fastlocals[i];
+		if (value != NULL) {
+			if (dict2insert(f->f_locals, name, value) != 0) {
+				err_clear();
+            }
+		}
+		else if (dict2lookup(f->f_locals, name) != NULL) {
+			if (dict2remove(f->f_locals, name) != 0) {
+				err_clear();
+            }
+		}
+	}
+}
+
+void
+locals2fast(frameobject *f)
+{
+	object *value;
+
+	if (!(f->f_code->co_flags & CO_OPTIMIZED) || f->f_locals == NULL) {
+		return;
+    }
+	for (int i = 0; i < f->f_nlocals; i++) {
+		value = dict2lookup(f->f_locals,
+                            getlistitem(f->f_code->co_varnames, i));
+		XINCREF(value);
+		XDECREF(f->f_fastlocals[i]);
+		f->f_fastlocals[i] = value;
+	}
+}
@@ -19,20 +19,29 @@ typedef struct _frame {
 	codeobject		*f_code;		/* code segment */
 	object 			*f_globals;		/* global symbol table (dictobject) */
 	object 			*f_locals;		/* local symbol table (dictobject) */
-	object			**f_valuestack;	/* malloc'ed array */
-	block			*f_blockstack;	/* malloc'ed array */
+	object			**f_fastlocals;	/* inline array, for CO_OPTIMIZED */
+	object			**f_valuestack;	/* inline array */
+	block			*f_blockstack;	/* inline array */
+	int 			f_allocated;	/* bytes allocated for the arrays */
+	int 			f_nlocals;		/* size of f_fastlocals */
 	int 			f_nvalues;		/* size of f_valuestack */
 	int 			f_nblocks;		/* size of f_blockstack */
 	int 			f_iblock;		/* index in f_blockstack */
+	/* While the frame waits for a frame it called, or is suspended in a
+	   generator, see eval_frame(); f_stacktop is NULL once it has ended */
+	object			**f_stacktop;	/* top of f_valuestack */
+	int				f_lasti;		/* offset of the instruction to resume */
+	int				f_lineno;		/* current line number */
 } frameobject;
 
 /* Standard object interface */
 
 extern typeobject Frametype;
-#define is_frameobject(op) ((op)->ob_type == &Frametype)
+#define is_frameobject(op) (TYPEOF(op) == &Frametype)
 
 frameobject * newframeobject(frameobject *, codeobject *, object *, object *,
 							 int, int);
+int clearframefreelist(void); /* Returns the number of frames freed */
 
 /* The rest of the interface is specific for frame objects */
 
@@ -53,6 +62,11 @@ frameobject * newframeobject(frameobject *, codeobject *, object *, object *,
 void setup_block(frameobject *, int, int, int);
 block *pop_block(frameobject *);
 
+/* Conversion between the local variable slots and the locals dictionary.
+   fast2locals() creates f_locals if the frame doesn't have one yet. */
+void fast2locals(frameobject *);
+void locals2fast(frameobject *);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,7 +8,7 @@ extern "C" {
 /* Function object interface */
 
 extern typeobject Functype;
-#define is_funcobject(op) ((op)->ob_type == &Functype)
+#define is_funcobject(op) (TYPEOF(op) == &Functype)
 
 extern object *newfuncobject(object *, object *);
 extern object *getfunccode(object *);
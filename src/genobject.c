@@ -0,0 +1,100 @@
+/* Generator object implementation */
+
+#include <stdio.h>
+
+#include "object.h"
+#include "objimpl.h"
+#include "errors.h"
+#include "malloc.h"
+#include "compile.h"
+#include "frameobject.h"
+#include "ceval.h"
+#include "genobject.h"
+
+/* The frame f is made by the call of the function and hasn't run yet; it
+   is only linked to a calling frame while it runs (see resume_frame()) */
+object *
+newgenobject(frameobject *f)
+{
+	genobject *g = NEWOBJ(genobject, &Gentype);
+
+	if (g == NULL) {
+		return NULL;
+    }
+	INCREF(f);
+	g->gi_frame = f;
+	g->gi_running = 0;
+	XDECREF(f->f_back);
+	f->f_back = NULL;
+	return (object *)g;
+}
+
+object *
+gen_next(object *v)
+{
+	genobject *g;
+	frameobject *f;
+	object *x;
+
+	if (!is_genobject(v)) {
+		err_badcall();
+		return NULL;
+	}
+	g = (genobject *)v;
+	if (g->gi_running) {
+		err_setstr(RuntimeError, "generator already running");
+		return NULL;
+	}
+	if ((f = g->gi_frame) == NULL) {
+		return NULL;
+    }
+	g->gi_running = 1;
+	x = resume_frame(f);
+	g->gi_running = 0;
+	/* A frame that has ended has no value stack left (see eval_frame());
+	   what it returned is not an item */
+	if (f->f_stacktop == NULL) {
+		g->gi_frame = NULL;
+		DECREF(f);
+		XDECREF(x);
+		x = NULL;
+	}
+	return x;
+}
+
+/* Methods */
+
+static object *
+gen_iter(genobject *g)
+{
+	INCREF(g);
+	return (object *)g;
+}
+
+static void
+gen_dealloc(genobject *g)
+{
+	XDECREF(g->gi_frame);
+	DEL(g);
+}
+
+typeobject Gentype = {
+	OB_HEAD_INIT(&Typetype)
+	0,
+	"generator",
+	sizeof(genobject),
+	0,
+	(destructor)gen_dealloc,	/*tp_dealloc*/
+	0,							/*tp_print*/
+	0,							/*tp_getattr*/
+	0,							/*tp_setattr*/
+	0,							/*tp_compare*/
+	0,							/*tp_repr*/
+	0,							/*tp_as_number*/
+	0,							/*tp_as_sequence*/
+	0,							/*tp_as_mapping*/
+	0,							/*tp_hash*/
+	0,							/*tp_methods*/
+	(getiterfunc)gen_iter,		/*tp_iter*/
+	(iternextfunc)gen_next,		/*tp_iternext*/
+};
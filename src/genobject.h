@@ -0,0 +1,38 @@
+#ifndef Py_GENOBJECT_H
+#define Py_GENOBJECT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Generator object interface */
+
+/* 123456789-123456789-123456789-123456789-123456789-123456789-123456789-12
+
+Calling a function whose code contains 'yield' (see CO_GENERATOR in
+compile.h) doesn't run it but returns a generator object, which holds the
+frame of the call.  gen_next() runs the frame until its next 'yield' and
+returns the value yielded, leaving the frame suspended where it was; it is
+the tp_iternext of generators, which are their own iterators.
+Once the function has returned, gen_next() returns NULL without setting an
+exception; it also returns NULL, with an exception set, if the function
+raised one. */
+
+typedef struct {
+	OB_HEAD
+	struct _frame *gi_frame;	/* NULL once the function has ended */
+	int gi_running;				/* set while gen_next() runs the frame */
+} genobject;
+
+extern typeobject Gentype;
+
+#define is_genobject(op) (TYPEOF(op) == &Gentype)
+
+extern object *newgenobject(struct _frame *);
+extern object *gen_next(object *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !Py_GENOBJECT_H */
@@ -1,6 +1,9 @@
 /* Module definition and import implementation */
 
 #include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "object.h"
 #include "stringobject.h"
@@ -14,10 +17,19 @@
 #include "sysmodule.h"
 #include "pythonrun.h"
 #include "modsupport.h"
+#include "compile.h"
+#include "ceval.h"
+#include "marshal.h"
 
 /* Define pathname separator used in file names */
 #define SEP '/'
 
+/* Magic word at the start of compiled code files.  Change it whenever the
+   marshal format, the opcodes or the code generated for them change, so
+   that stale files are recompiled.  The upper bytes are \r\n, so that a
+   file mangled by a text mode transfer is rejected too. */
+#define MAGIC (0x0916L | ((long)'\r' << 16) | ((long)'\n' << 24))
+
 static object *modules;
 static int init_builtin(char *name);
 
@@ -89,13 +101,97 @@ open_module(char *name, char *suffix, char *namebuf)
 	return fp;
 }
 
-static object *
-get_module(object *m, char *name, object **m_ret)
+/* Compiled code of a module foo.py is cached in foo.pyc, or in foo.pyo if
+   the peephole optimizer is on, since the code differs.  The file holds the
+   magic word, the modification time and the size of the source and the
+   marshalled code object.  The size catches a source rewritten within the
+   second of its modification time.  Both are stored as 32 bits, and
+   compared as such.  A cache file that is stale or can't be read is
+   ignored, and failing to write one is no error. */
+
+static void
+make_compiled_pathname(char *pathname, char *cpathname)
+{
+	strcpy(cpathname, pathname);
+	strcat(cpathname, optimizeflag ? "o" : "c");
+}
+
+static codeobject *
+read_compiled_module(char *cpathname, long mtime, long size)
+{
+	FILE *fp;
+	object *v;
+
+	if ((fp = fopen(cpathname, "rb")) == NULL) {
+		return NULL;
+    }
+	if (rd_long(fp) != MAGIC
+        || (rd_long(fp) & 0xffffffffL) != (mtime & 0xffffffffL)
+        || (rd_long(fp) & 0xffffffffL) != (size & 0xffffffffL))
+    {
+		fclose(fp);
+		return NULL;
+	}
+	v = rd_object(fp);
+	fclose(fp);
+	if (v == NULL || !is_codeobject(v)) {
+		XDECREF(v);
+		err_clear();
+		return NULL;
+	}
+	return (codeobject *)v;
+}
+
+static void
+write_compiled_module(codeobject *co, char *cpathname, long mtime,
+                      long size)
+{
+	FILE *fp;
+
+	if ((fp = fopen(cpathname, "wb")) == NULL) {
+		return;
+    }
+	/* The magic word is written last, so a partly written file is never
+	   taken for a valid one */
+	wr_long(0L, fp);
+	wr_long(mtime, fp);
+	wr_long(size, fp);
+	wr_object((object *)co, fp);
+	if (fflush(fp) != 0 || ferror(fp)) {
+		fclose(fp);
+		unlink(cpathname);
+		return;
+	}
+	fseek(fp, 0L, 0);
+	wr_long(MAGIC, fp);
+	fclose(fp);
+}
+
+static codeobject *
+parse_source_module(FILE *fp, char *pathname)
 {
-	object *d;
+	codeobject *co;
 	node *n;
 	int err;
+
+	err = parse_file(fp, pathname, file_input, &n);
+	if (err != E_DONE) {
+		err_input(err);
+		return NULL;
+	}
+	co = compile(n, pathname);
+	freetree(n);
+	return co;
+}
+
+static object *
+get_module(object *m, char *name, object **m_ret)
+{
+	codeobject *co;
+	object *d, *v;
+	struct stat st;
 	char namebuf[256];
+	char cnamebuf[258];
 	FILE *fp = open_module(name, ".py", namebuf);
 
 	if (fp == NULL) {
@@ -107,22 +203,35 @@ get_module(object *m, char *name, object **m_ret)
         }
 		return NULL;
 	}
-	err = parse_file(fp, namebuf, file_input, &n);
+	make_compiled_pathname(namebuf, cnamebuf);
+	if (fstat(fileno(fp), &st) != 0) {
+		st.st_mtime = 0;
+		st.st_size = 0;
+	}
+	co = read_compiled_module(cnamebuf, (long)st.st_mtime, (long)st.st_size);
+	if (co == NULL) {
+		co = parse_source_module(fp, namebuf);
+		if (co != NULL) {
+			write_compiled_module(co, cnamebuf, (long)st.st_mtime,
+                                  (long)st.st_size);
+        }
+	}
 	fclose(fp);
-	if (err != E_DONE) {
-		err_input(err);
+	if (co == NULL) {
 		return NULL;
-	}
+    }
 	if (m == NULL) {
 		m = add_module(name);
 		if (m == NULL) {
-			freetree(n);
+			DECREF(co);
 			return NULL;
 		}
 		*m_ret = m;
 	}
 	d = getmoduledict(m);
-	return run_node(n, namebuf, d, d);
+	v = eval_code(co, d, d, (object *)NULL);
+	DECREF(co);
+	return v;
 }
 
 static object *
@@ -1,5 +1,7 @@
 /* Integer object implementation */
 
+#include <limits.h>
+
 #include "object.h"
 #include "intobject.h"
 #include "stringobject.h"
@@ -34,7 +36,8 @@ err_zdiv()
 
 /* Integers are quite normal objects, to make object handling uniform.  (Using
    odd pointers to represent integers would save much space but require extra
-   checks for this special case throughout the code.)  Since, a typical Python
+   checks for this special case throughout the code; USE_TAGGED_INTS does
+   this for most integers, see object.h.)  Since, a typical Python
    program spends much of its time allocating and deallocating integers, these
    operations should be very fast. Therefore we use a dedicated allocation
    scheme with a much lower overhead (in space and time) than straight
@@ -62,11 +65,22 @@ fill_free_list()
 
 static intobject *free_list = NULL;
 
+#ifdef USE_TAGGED_INTS
+/* The range of values that can be kept in a tagged pointer */
+#define TAGGED_MIN	(-TAGGED_MAX - 1)
+#define TAGGED_MAX	((long)(~0UL >> 2))
+#endif
+
 object *
 newintobject(long ival)
 {
 	register intobject *v;
 
+#ifdef USE_TAGGED_INTS
+	if (ival >= TAGGED_MIN && ival <= TAGGED_MAX) {
+		return (object *)(((unsigned long)ival << 1) | 1);
+    }
+#endif
 	if (free_list == NULL) {
 		if ((free_list = fill_free_list()) == NULL) {
 			return NULL;
@@ -95,7 +109,7 @@ getintvalue(register object *op)
 		return -1;
 	}
 	else {
-		return ((intobject *)op)->ob_ival;
+		return GETINTVALUE(op);
     }
 }
 
@@ -104,7 +118,7 @@ getintvalue(register object *op)
 static void
 int_print(intobject *v, FILE *fp, int flags)
 {
-	fprintf(fp, "%ld", v->ob_ival);
+	fprintf(fp, "%ld", GETINTVALUE(v));
 }
 
 static object *
@@ -112,19 +126,27 @@ int_repr(intobject *v)
 {
 	char buf[20];
 
-	sprintf(buf, "%ld", v->ob_ival);
+	sprintf(buf, "%ld", GETINTVALUE(v));
 	return newstringobject(buf);
 }
 
 static int
 int_compare(intobject *v, intobject *w)
 {
-	register long i = v->ob_ival;
-	register long j = w->ob_ival;
+	register long i = GETINTVALUE(v);
+	register long j = GETINTVALUE(w);
 
 	return (i < j) ? -1 : (i > j) ? 1 : 0;
 }
 
+static long
+int_hash(intobject *v)
+{
+	long x = GETINTVALUE(v);
+
+	return x == -1 ? -2 : x;
+}
+
 static object *
 int_add(intobject *v, register object *w)
 {
@@ -134,8 +156,8 @@ int_add(intobject *v, register object *w)
 		err_badarg();
 		return NULL;
 	}
-	a = v->ob_ival;
-	b = ((intobject *)w)->ob_ival;
+	a = GETINTVALUE(v);
+	b = GETINTVALUE(w);
 	x = a + b;
 	if ((x ^ a) < 0 && (x ^ b) < 0) {
 		return err_ovf();
@@ -152,8 +174,8 @@ int_sub(intobject *v, register object *w)
 		err_badarg();
 		return NULL;
 	}
-	a = v->ob_ival;
-	b = ((intobject *)w)->ob_ival;
+	a = GETINTVALUE(v);
+	b = GETINTVALUE(w);
 	x = a - b;
 	if ((x ^ a) < 0 && (x ^~ b) < 0) {
 		return err_ovf();
@@ -164,20 +186,20 @@ int_sub(intobject *v, register object *w)
 static object *
 int_mul(intobject *v, register object *w)
 {
-	register long a, b;
-	double x;
+	register long a, b, x;
 
 	if (!is_intobject(w)) {
 		err_badarg();
 		return NULL;
 	}
-	a = v->ob_ival;
-	b = ((intobject *)w) -> ob_ival;
-	x = (double)a * (double)b;
-	if (x > 0x7fffffff || x < (double)(long)0x80000000) {
+	a = GETINTVALUE(v);
+	b = GETINTVALUE(w);
+	/* Multiply unsigned, so that an overflow wraps, and divide back */
+	x = (long)((unsigned long)a * (unsigned long)b);
+	if (a == -1 ? b == LONG_MIN : a != 0 && x / a != b) {
 		return err_ovf();
     }
-	return newintobject(a * b);
+	return newintobject(x);
 }
 
 static object *
@@ -187,10 +209,10 @@ int_div(intobject *v, register object *w)
 		err_badarg();
 		return NULL;
 	}
-	if (((intobject *)w)->ob_ival == 0) {
+	if (GETINTVALUE(w) == 0) {
 		return err_zdiv();
     }
-	return newintobject(v->ob_ival / ((intobject *)w)->ob_ival);
+	return newintobject(GETINTVALUE(v) / GETINTVALUE(w));
 }
 
 static object *
@@ -200,10 +222,10 @@ int_rem(intobject *v, register object *w)
 		err_badarg();
 		return NULL;
 	}
-	if (((intobject *)w)->ob_ival == 0) {
+	if (GETINTVALUE(w) == 0) {
 		return err_zdiv();
     }
-	return newintobject(v->ob_ival % ((intobject *)w)->ob_ival);
+	return newintobject(GETINTVALUE(v) % GETINTVALUE(w));
 }
 
 static object *
@@ -216,8 +238,8 @@ int_pow(intobject *v, register object *w)
 		err_badarg();
 		return NULL;
 	}
-	iv = v->ob_ival;
-	iw = ((intobject *)w)->ob_ival;
+	iv = GETINTVALUE(v);
+	iw = GETINTVALUE(w);
 	neg = 0;
 	if (iw < 0) {
 		neg = 1, iw = -iw;
@@ -239,7 +261,7 @@ int_pow(intobject *v, register object *w)
 static object *
 int_neg(intobject *v)
 {
-	register long a = v->ob_ival, x;
+	register long a = GETINTVALUE(v), x;
 	x = -a;
 
 	if (a < 0 && x < 0) {
@@ -281,4 +303,5 @@ typeobject Inttype = {
 	&int_as_number,				/*tp_as_number*/
 	0,							/*tp_as_sequence*/
 	0,							/*tp_as_mapping*/
+	(hashfunc)int_hash,			/*tp_hash*/
 };
@@ -27,7 +27,11 @@ typedef struct {
 
 extern typeobject Inttype;
 
+#ifdef USE_TAGGED_INTS
+#define is_intobject(op) (IS_TAGGED(op) || (op)->ob_type == &Inttype)
+#else
 #define is_intobject(op) ((op)->ob_type == &Inttype)
+#endif
 
 extern object *newintobject(long);
 extern long getintvalue(object *);
@@ -46,7 +50,12 @@ extern intobject FalseObject, TrueObject; /* Don't use these directly */
 #define False ((object *)&FalseObject)
 #define True ((object *)&TrueObject)
 /* Macro, trading safety for speed */
-#define GETINTVALUE(op) ((op)->ob_ival)
+#ifdef USE_TAGGED_INTS
+#define GETINTVALUE(op) \
+	(IS_TAGGED(op) ? (long)(op) >> 1 : ((intobject *)(op))->ob_ival)
+#else
+#define GETINTVALUE(op) (((intobject *)(op))->ob_ival)
+#endif
 
 #ifdef __cplusplus
 }
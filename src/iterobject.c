@@ -0,0 +1,85 @@
+/* Sequence iterator implementation */
+
+#include "object.h"
+#include "objimpl.h"
+#include "iterobject.h"
+#include "errors.h"
+#include "malloc.h"
+
+object *
+newseqiterobject(object *seq)
+{
+	seqiterobject *it;
+
+	if (TYPEOF(seq)->tp_as_sequence == NULL) {
+		err_badcall();
+		return NULL;
+	}
+	it = NEWOBJ(seqiterobject, &Seqitertype);
+	if (it == NULL) {
+		return NULL;
+    }
+	INCREF(seq);
+	it->it_seq = seq;
+	it->it_index = 0;
+	return (object *)it;
+}
+
+/* Methods */
+
+static void
+seqiter_dealloc(seqiterobject *it)
+{
+	XDECREF(it->it_seq);
+	DEL(it);
+}
+
+static object *
+seqiter_iter(seqiterobject *it)
+{
+	INCREF(it);
+	return (object *)it;
+}
+
+static object *
+seqiter_next(seqiterobject *it)
+{
+	object *seq = it->it_seq;
+	sequence_methods *sq;
+	int n;
+
+	if (seq == NULL) {
+		return NULL;
+    }
+	sq = TYPEOF(seq)->tp_as_sequence;
+	if ((n = (*sq->sq_length)(seq)) < 0) {
+		return NULL;
+    }
+	if (it->it_index >= n) {
+		it->it_seq = NULL;
+		DECREF(seq);
+		return NULL;
+	}
+	return (*sq->sq_item)(seq, it->it_index++);
+}
+
+typeobject Seqitertype = {
+	OB_HEAD_INIT(&Typetype)
+	0,
+	"iterator",
+	sizeof(seqiterobject),
+	0,
+	(destructor)seqiter_dealloc,	/*tp_dealloc*/
+	0,								/*tp_print*/
+	0,								/*tp_getattr*/
+	0,								/*tp_setattr*/
+	0,								/*tp_compare*/
+	0,								/*tp_repr*/
+	0,								/*tp_as_number*/
+	0,								/*tp_as_sequence*/
+	0,								/*tp_as_mapping*/
+	0,								/*tp_hash*/
+	0,								/*tp_methods*/
+	(getiterfunc)seqiter_iter,		/*tp_iter*/
+	(iternextfunc)seqiter_next,		/*tp_iternext*/
+};
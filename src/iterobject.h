@@ -0,0 +1,35 @@
+#ifndef Py_ITEROBJECT_H
+#define Py_ITEROBJECT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Sequence iterator interface */
+
+/* 123456789-123456789-123456789-123456789-123456789-123456789-123456789-12
+
+A sequence iterator gets the items of any object with sequence methods by
+indexing it from 0 until the index reaches its length, which is looked at
+again for every item, so that a list may change while it is looped over.
+getiter() (see object.c) makes one for a sequence whose type has no
+tp_iter of its own; types with a cheaper way to go through their items,
+like lists, tuples and dictionaries, have their own iterators. */
+
+typedef struct {
+	OB_HEAD
+	object *it_seq;		/* NULL once the end has been reached */
+	int it_index;
+} seqiterobject;
+
+extern typeobject Seqitertype;
+
+#define is_seqiterobject(op) (TYPEOF(op) == &Seqitertype)
+
+extern object *newseqiterobject(object *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !Py_ITEROBJECT_H */
@@ -19,7 +19,7 @@ newlistobject(int size)
 		err_badcall();
 		return NULL;
 	}
-	op = (listobject *)malloc(sizeof(listobject));
+	op = (listobject *)mem_malloc(sizeof(listobject));
 	if (op == NULL) {
 		return err_nomem();
 	}
@@ -27,15 +27,16 @@ newlistobject(int size)
 		op->ob_item = NULL;
 	}
 	else {
-		op->ob_item = (object **)malloc(size * sizeof(object *));
+		op->ob_item = NEW(object *, size);
 		if (op->ob_item == NULL) {
-			free((ANY *)op);
+			DEL(op);
 			return err_nomem();
 		}
 	}
 	NEWREF(op);
 	op->ob_type = &Listtype;
 	op->ob_size = size;
+	op->ob_allocated = size;
 	for (int i = 0; i < size; i++) {
 		op->ob_item[i] = NULL;
     }
@@ -95,6 +96,34 @@ setlistitem(register object *op, register int i, register object *newitem)
 	return 0;
 }
 
+/* Make room for newsize items.  The array grows by about an eighth more than
+   is asked for, so that n appends cost O(n) copying in all.  It is only
+   shrunk when less than a quarter of it is in use, so that alternating
+   inserts and deletes near a boundary don't realloc every time.  Shrinking
+   can't fail: if realloc() does, the old array is kept. */
+static int
+list_resize(listobject *a, int newsize)
+{
+	object **items = a->ob_item;
+	int allocated = a->ob_allocated;
+
+	if (newsize <= allocated && newsize >= allocated / 4) {
+		return 0;
+    }
+	allocated = newsize + (newsize >> 3) + (newsize < 9 ? 3 : 6);
+	RESIZE(items, object *, allocated);
+	if (items == NULL) {
+		if (newsize <= a->ob_allocated) {
+			return 0;
+        }
+		err_nomem();
+		return -1;
+	}
+	a->ob_item = items;
+	a->ob_allocated = allocated;
+	return 0;
+}
+
 static int
 ins1(listobject *self, int where, object *v)
 {
@@ -105,12 +134,10 @@ ins1(listobject *self, int where, object *v)
 		err_badcall();
 		return -1;
 	}
-	items = self->ob_item;
-	RESIZE(items, object *, self->ob_size + 1);
-	if (items == NULL) {
-		err_nomem();
+	if (list_resize(self, self->ob_size + 1) != 0) {
 		return -1;
-	}
+    }
+	items = self->ob_item;
 	if (where < 0) {
 		where = 0;
     }
@@ -122,7 +149,6 @@ ins1(listobject *self, int where, object *v)
     }
 	INCREF(v);
 	items[where] = v;
-	self->ob_item = items;
 	self->ob_size++;
 	return 0;
 }
@@ -158,9 +184,9 @@ list_dealloc(listobject *op)
         }
 	}
 	if (op->ob_item != NULL) {
-		free((ANY *)op->ob_item);
+		DEL(op->ob_item);
     }
-	free((ANY *)op);
+	DEL(op);
 }
 
 static void
@@ -179,21 +205,20 @@ list_print(listobject *op, FILE *fp, int flags)
 object *
 list_repr(listobject *v)
 {
-	object *s = newstringobject("["), *t, *comma = newstringobject(", ");
+	stringbuilder sb;
 
-	for (int i = 0; i < v->ob_size && s != NULL; i++) {
+	sb_init(&sb, 2 + 4 * v->ob_size);
+	sb_addchars(&sb, "[", 1);
+	for (int i = 0; i < v->ob_size; i++) {
 		if (i > 0) {
-			joinstring(&s, comma);
+			sb_addchars(&sb, ", ", 2);
         }
-		t = reprobject(v->ob_item[i]);
-		joinstring(&s, t);
-		DECREF(t);
-	}
-	DECREF(comma);
-	t = newstringobject("]");
-	joinstring(&s, t);
-	DECREF(t);
-	return s;
+		if (sb_addrepr(&sb, v->ob_item[i]) != 0) {
+			break;
+        }
+	}
+	sb_addchars(&sb, "]", 1);
+	return sb_finish(&sb);
 }
 
 static int
@@ -334,23 +359,21 @@ list_ass_slice(listobject *a, int ilow, int ihigh, object * v)
 				item[k+d] = item[k];
             }
 			a->ob_size += d;
-			RESIZE(item, object *, a->ob_size); /* Can't fail */
-			a->ob_item = item;
+			list_resize(a, a->ob_size); /* Can't fail */
+			item = a->ob_item;
 		}
 	}
 	else { /* Insert d items; DECREF ihigh-ilow items */
-		RESIZE(item, object *, a->ob_size + d);
-		if (item == NULL) {
-			err_nomem();
+		if (list_resize(a, a->ob_size + d) != 0) {
 			return -1;
-		}
+        }
+		item = a->ob_item;
 		for (k = a->ob_size; --k >= ihigh;) {
 			item[k + d] = item[k];
         }
 		for (/*k = ihigh - 1*/; k >= ilow; --k) {
 			DECREF(item[k]);
         }
-		a->ob_item = item;
 		a->ob_size += d;
 	}
 	for (k = 0; k < n; k++, ilow++) {
@@ -389,17 +412,17 @@ ins(listobject *self, int where, object *v)
 }
 
 static object *
-listinsert(listobject *self, object *args)
+listinsert(listobject *self, object **args, int nargs)
 {
 	int i;
-	if (args == NULL || !is_tupleobject(args) || gettuplesize(args) != 2) {
+	if (nargs != 2) {
 		err_badarg();
 		return NULL;
 	}
-	if (!getintarg(gettupleitem(args, 0), &i)) {
+	if (!getintarg(args[0], &i)) {
 		return NULL;
     }
-	return ins(self, i, gettupleitem(args, 1));
+	return ins(self, i, args[1]);
 }
 
 static object *
@@ -451,7 +474,7 @@ sortlist(object *v)
 
 static struct methodlist list_methods[] = {
 	{"append",	(method)listappend},
-	{"insert",	(method)listinsert},
+	{"insert",	(method)listinsert,	METH_FAST},
 	{"sort",	(method)listsort},
 	{NULL,		NULL}	/* sentinel */
 };
@@ -472,6 +495,83 @@ static sequence_methods list_as_sequence = {
 	(intintobjargproc)list_ass_slice,	/*sq_ass_slice*/
 };
 
+/* List iterators index the list directly; its length is looked at again
+   for every item, since the loop may change the list */
+
+typedef struct {
+	OB_HEAD
+	listobject *it_seq;		/* NULL once the end has been reached */
+	int it_index;
+} listiterobject;
+
+static void
+listiter_dealloc(listiterobject *it)
+{
+	XDECREF(it->it_seq);
+	DEL(it);
+}
+
+static object *
+listiter_iter(listiterobject *it)
+{
+	INCREF(it);
+	return (object *)it;
+}
+
+static object *
+listiter_next(listiterobject *it)
+{
+	listobject *op = it->it_seq;
+	object *v;
+
+	if (op == NULL) {
+		return NULL;
+    }
+	if (it->it_index < op->ob_size) {
+		v = op->ob_item[it->it_index++];
+		INCREF(v);
+		return v;
+	}
+	it->it_seq = NULL;
+	DECREF(op);
+	return NULL;
+}
+
+static typeobject Listitertype = {
+	OB_HEAD_INIT(&Typetype)
+	0,
+	"listiterator",
+	sizeof(listiterobject),
+	0,
+	(destructor)listiter_dealloc,	/*tp_dealloc*/
+	0,								/*tp_print*/
+	0,								/*tp_getattr*/
+	0,								/*tp_setattr*/
+	0,								/*tp_compare*/
+	0,								/*tp_repr*/
+	0,								/*tp_as_number*/
+	0,								/*tp_as_sequence*/
+	0,								/*tp_as_mapping*/
+	0,								/*tp_hash*/
+	0,								/*tp_methods*/
+	(getiterfunc)listiter_iter,		/*tp_iter*/
+	(iternextfunc)listiter_next,	/*tp_iternext*/
+};
+
+static object *
+list_iter(listobject *op)
+{
+	listiterobject *it = NEWOBJ(listiterobject, &Listitertype);
+
+	if (it == NULL) {
+		return NULL;
+    }
+	INCREF(op);
+	it->it_seq = op;
+	it->it_index = 0;
+	return (object *)it;
+}
+
 typeobject Listtype = {
 	OB_HEAD_INIT(&Typetype)
 	0,
@@ -487,4 +587,7 @@ typeobject Listtype = {
 	0,							/*tp_as_number*/
 	&list_as_sequence,			/*tp_as_sequence*/
 	0,							/*tp_as_mapping*/
+	0,							/*tp_hash*/
+	list_methods,				/*tp_methods*/
+	(getiterfunc)list_iter,		/*tp_iter*/
 };
@@ -16,15 +16,19 @@ Out-of-range indices or non-list objects are ignored.
 *** WARNING *** setlistitem does not increment the new item's reference count,
 but does decrement the reference count of the item it replaces, if not nil.  It
 does *decrement* the reference count if it is *not* inserted in the list.  Si-
-milarly, getlistitem does not increment the returned item's reference count. */
+milarly, getlistitem does not increment the returned item's reference count.
+
+The item array is over-allocated: ob_allocated slots exist, of which the first
+ob_size are in use, so that appending needs a realloc only now and then. */
 
 typedef struct {
 	OB_VARHEAD
 	object **ob_item;
+	int ob_allocated;
 } listobject;
 
 extern typeobject Listtype;
-#define is_listobject(op) ((op)->ob_type == &Listtype)
+#define is_listobject(op) (TYPEOF(op) == &Listtype)
 
 extern object *newlistobject(int size);
 extern int getlistsize(object *);
@@ -6,21 +6,41 @@ extern "C" {
 #endif
 
 /* Lowest-level memory allocation interface */
+#include <stdio.h>
 #include <stdlib.h>
 
 #ifndef ANY
 #define ANY char
 #endif
 
-#define NEW(type, n) ((type *)malloc((n) * sizeof(type)))
+/* Small requests are served from size-class pools, see obmalloc.c; others
+   go to malloc().  DEL() accepts memory from either, but memory from NEW()
+   or RESIZE() must not be given to free() or realloc(). */
+
+extern ANY *mem_malloc(size_t);
+extern ANY *mem_realloc(ANY *, size_t);
+extern void mem_free(ANY *);
+
+#define NEW(type, n) ((type *)mem_malloc((n) * sizeof(type)))
 #define RESIZE(p, type, n) \
-	if ((p) == NULL) \
-		(p) =  (type *)malloc((n) * sizeof(type)); \
-	else \
-		(p) = (type *)realloc((char *)(p), (n) * sizeof(type))
-#define DEL(p) free((char *)p)
+	((p) = (type *)mem_realloc((char *)(p), (n) * sizeof(type)))
+#define DEL(p) mem_free((char *)(p))
 #define XDEL(p) if ((p) == NULL) ; else DEL(p)
 
+/* Statistics of the pool allocator */
+struct memstats {
+	long ms_arenas;		/* Arenas mapped now */
+	long ms_maxarenas;	/* Most arenas mapped at any time */
+	long ms_allocated;	/* Arenas ever mapped */
+	long ms_released;	/* Arenas unmapped again */
+	long ms_pools;		/* Pools in use */
+	long ms_blocks;		/* Blocks in use */
+	long ms_bytes;		/* Bytes in the blocks in use */
+};
+
+extern void mem_getstats(struct memstats *);
+extern void mem_printstats(FILE *);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,289 @@
+/* Write Python objects to files and read them back */
+
+/* This is used by import.c to keep compiled code of modules in files, so the
+   formats only have to agree between runs of the same interpreter version;
+   import.c puts a magic number in front that must be changed whenever the
+   format or the meaning of the code changes.  All integers are written
+   least significant byte first. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "object.h"
+#include "intobject.h"
+#include "floatobject.h"
+#include "stringobject.h"
+#include "tupleobject.h"
+#include "listobject.h"
+#include "compile.h"
+#include "errors.h"
+#include "marshal.h"
+
+#define TYPE_NULL		'0'
+#define TYPE_NONE		'N'
+#define TYPE_INT		'i'
+#define TYPE_INT64		'I'
+#define TYPE_FLOAT		'f'
+#define TYPE_STRING		's'
+#define TYPE_TUPLE		'('
+#define TYPE_LIST		'['
+#define TYPE_CODE		'C'
+#define TYPE_UNKNOWN	'?'
+
+#define wr_byte(c, fp) putc((c), (fp))
+
+void
+wr_long(long x, FILE *fp)
+{
+	wr_byte((int)( x        & 0xff), fp);
+	wr_byte((int)((x >>  8) & 0xff), fp);
+	wr_byte((int)((x >> 16) & 0xff), fp);
+	wr_byte((int)((x >> 24) & 0xff), fp);
+}
+
+void
+wr_object(object *v, FILE *fp)
+{
+	long x, hi;
+	int n;
+	char buf[100];
+
+	if (v == NULL) {
+		wr_byte(TYPE_NULL, fp);
+    }
+	else if (v == None) {
+		wr_byte(TYPE_NONE, fp);
+    }
+	else if (is_intobject(v)) {
+		x = getintvalue(v);
+		/* Shift in two steps, in case a long has only 32 bits */
+		hi = (x >> 16) >> 16;
+		if ((hi == 0 && !(x & 0x80000000L))
+            || (hi == -1 && (x & 0x80000000L)))
+        {
+			wr_byte(TYPE_INT, fp);
+			wr_long(x, fp);
+		}
+		else {
+			wr_byte(TYPE_INT64, fp);
+			wr_long(x, fp);
+			wr_long(hi, fp);
+		}
+	}
+	else if (is_floatobject(v)) {
+		sprintf(buf, "%.17g", getfloatvalue(v));
+		n = strlen(buf);
+		wr_byte(TYPE_FLOAT, fp);
+		wr_byte(n, fp);
+		fwrite(buf, 1, n, fp);
+	}
+	else if (is_stringobject(v)) {
+		n = getstringsize(v);
+		wr_byte(TYPE_STRING, fp);
+		wr_long((long)n, fp);
+		fwrite(getstringvalue(v), 1, n, fp);
+	}
+	else if (is_tupleobject(v)) {
+		n = gettuplesize(v);
+		wr_byte(TYPE_TUPLE, fp);
+		wr_long((long)n, fp);
+		for (int i = 0; i < n; i++) {
+			wr_object(gettupleitem(v, i), fp);
+        }
+	}
+	else if (is_listobject(v)) {
+		n = getlistsize(v);
+		wr_byte(TYPE_LIST, fp);
+		wr_long((long)n, fp);
+		for (int i = 0; i < n; i++) {
+			wr_object(getlistitem(v, i), fp);
+        }
+	}
+	else if (is_codeobject(v)) {
+		codeobject *co = (codeobject *)v;
+		wr_byte(TYPE_CODE, fp);
+		wr_object((object *)co->co_code, fp);
+		wr_object(co->co_consts, fp);
+		wr_object(co->co_names, fp);
+		wr_object(co->co_varnames, fp);
+		wr_object(co->co_filename, fp);
+		wr_long((long)co->co_flags, fp);
+		wr_long((long)co->co_stacksize, fp);
+		wr_long((long)co->co_maxblocks, fp);
+	}
+	else {
+		wr_byte(TYPE_UNKNOWN, fp);
+	}
+}
+
+#define rd_byte(fp) getc(fp)
+
+long
+rd_long(FILE *fp)
+{
+	register long x;
+
+	x = rd_byte(fp);
+	x |= (long)rd_byte(fp) << 8;
+	x |= (long)rd_byte(fp) << 16;
+	x |= (long)rd_byte(fp) << 24;
+	/* Sign extension for 64-bit machines */
+	return (long)(((unsigned long)x ^ 0x80000000UL) - 0x80000000UL);
+}
+
+static object *
+bad_data(void)
+{
+	err_setstr(RuntimeError, "bad marshal data");
+	return NULL;
+}
+
+/* Replace the strings in a list of names by their interned copies */
+static int
+intern_names(object *list)
+{
+	object *v;
+
+	for (int i = getlistsize(list); --i >= 0; ) {
+		v = getlistitem(list, i);
+		if (!is_stringobject(v)) {
+			return -1;
+        }
+		if ((v = internstring(getstringvalue(v))) == NULL) {
+			return -1;
+        }
+		setlistitem(list, i, v);
+	}
+	return 0;
+}
+
+object *
+rd_object(FILE *fp)
+{
+	object *v, *w;
+	long x, n;
+	char buf[256];
+
+	switch (rd_byte(fp)) {
+
+		case EOF:
+			err_setstr(EOFError, "EOF read where object expected");
+			return NULL;
+
+		case TYPE_NULL:
+			return bad_data();
+
+		case TYPE_NONE:
+			INCREF(None);
+			return None;
+
+		case TYPE_INT:
+			return newintobject(rd_long(fp));
+
+		case TYPE_INT64:
+			x = rd_long(fp) & 0xffffffffL;
+			n = rd_long(fp);
+			/* Shift in two steps, in case a long has only 32 bits */
+			return newintobject(x | (long)(((unsigned long)n << 16) << 16));
+
+		case TYPE_FLOAT:
+			n = rd_byte(fp);
+			if (n == EOF || fread(buf, 1, (int)n, fp) != n) {
+				return bad_data();
+            }
+			buf[n] = '\0';
+			return newfloatobject(atof(buf));
+
+		case TYPE_STRING:
+			n = rd_long(fp);
+			if (n < 0) {
+				return bad_data();
+            }
+			if ((v = newsizedstringobject((char *)NULL, (int)n)) == NULL) {
+				return NULL;
+            }
+			if (fread(getstringvalue(v), 1, (int)n, fp) != n) {
+				DECREF(v);
+				return bad_data();
+			}
+			return v;
+
+		case TYPE_TUPLE:
+			n = rd_long(fp);
+			if (n < 0) {
+				return bad_data();
+            }
+			if ((v = newtupleobject((int)n)) == NULL) {
+				return NULL;
+            }
+			for (int i = 0; i < n; i++) {
+				if ((w = rd_object(fp)) == NULL) {
+					DECREF(v);
+					return NULL;
+				}
+				settupleitem(v, i, w);
+			}
+			return v;
+
+		case TYPE_LIST:
+			n = rd_long(fp);
+			if (n < 0) {
+				return bad_data();
+            }
+			if ((v = newlistobject((int)n)) == NULL) {
+				return NULL;
+            }
+			for (int i = 0; i < n; i++) {
+				if ((w = rd_object(fp)) == NULL) {
+					DECREF(v);
+					return NULL;
+				}
+				setlistitem(v, i, w);
+			}
+			return v;
+
+		case TYPE_CODE:
+			{
+				object *code = rd_object(fp);
+				object *consts = rd_object(fp);
+				object *names = rd_object(fp);
+				object *varnames = rd_object(fp);
+				object *filename = rd_object(fp);
+				int flags = (int)rd_long(fp);
+				int stacksize = (int)rd_long(fp);
+				int maxblocks = (int)rd_long(fp);
+
+				v = NULL;
+				if (code == NULL || consts == NULL || names == NULL
+                    || varnames == NULL || filename == NULL)
+                {
+					/* An error has been set already */
+				}
+				else if (feof(fp) || !is_listobject(names)
+                         || !is_listobject(varnames)
+                         || !is_stringobject(filename)
+                         || intern_names(names) != 0
+                         || intern_names(varnames) != 0)
+                {
+					if (!err_occurred()) {
+						bad_data();
+                    }
+				}
+				else {
+					v = (object *)newcodeobject(code, consts, names, varnames,
+                                                flags, stacksize, maxblocks,
+                                                getstringvalue(filename));
+				}
+				XDECREF(code);
+				XDECREF(consts);
+				XDECREF(names);
+				XDECREF(varnames);
+				XDECREF(filename);
+				return v;
+			}
+
+		default:
+			return bad_data();
+	}
+}
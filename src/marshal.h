@@ -0,0 +1,29 @@
+#ifndef Py_MARSHAL_H
+#define Py_MARSHAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Interface for marshal.c */
+
+/* 123456789-123456789-123456789-123456789-123456789-123456789-123456789-12
+
+Marshalling writes an object to a file in a machine-independent binary form,
+and reads it back.  Only the types that occur in code objects are supported:
+None, ints, floats, strings, tuples, lists and code objects themselves.  The
+names of a code object are interned when it is read back.
+
+rd_object returns a new reference, or NULL with an exception set if the data
+is bad or the file ends prematurely. */
+
+extern void wr_long(long, FILE *);
+extern void wr_object(object *, FILE *);
+extern long rd_long(FILE *);
+extern object *rd_object(FILE *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !Py_MARSHAL_H */
@@ -5,6 +5,8 @@
 #include "object.h"
 #include "objimpl.h"
 #include "stringobject.h"
+#include "dictobject.h"
+#include "tupleobject.h"
 #include "methodobject.h"
 #include "errors.h"
 #include "malloc.h"
@@ -14,17 +16,19 @@ typedef struct {
 	char	*m_name;
 	method 	m_meth;
 	object 	*m_self;
+	int		m_flags;
 } methodobject;
 
 /* char *name: static string */
 object *
-newmethodobject(char *name, method meth, object *self)
+newmethodobject(char *name, method meth, object *self, int flags)
 {
 	methodobject *op = NEWOBJ(methodobject, &Methodtype);
 
 	if (op != NULL) {
 		op->m_name = name;
 		op->m_meth = meth;
+		op->m_flags = flags;
 		if (self != NULL) {
 			INCREF(self);
         }
@@ -53,6 +57,57 @@ getself(object *op)
 	return ((methodobject *)op)->m_self;
 }
 
+/* A method without METH_FAST gets a tuple for two or more arguments, so a
+   METH_FAST method gets the items of such a tuple; anything else, including
+   a tuple of one item, is a single argument */
+object *
+callmethod(object *op, object *self, object *arg)
+{
+	methodobject *m = (methodobject *)op;
+
+	if (!(m->m_flags & METH_FAST)) {
+		return (*m->m_meth)(self, arg);
+    }
+	if (arg == NULL) {
+		return (*(fastmethod)m->m_meth)(self, (object **)NULL, 0);
+    }
+	if (is_tupleobject(arg) && gettuplesize(arg) >= 2) {
+		return (*(fastmethod)m->m_meth)(self, ((tupleobject *)arg)->ob_item,
+                                        gettuplesize(arg));
+    }
+	return (*(fastmethod)m->m_meth)(self, &arg, 1);
+}
+
+/* Two or more arguments are only made into a tuple for a method without
+   METH_FAST */
+object *
+fastcallmethod(object *op, object *self, object **args, int n)
+{
+	methodobject *m = (methodobject *)op;
+	object *arg, *v;
+	int i;
+
+	if (n == 1) {
+		return callmethod(op, self, args[0]);
+    }
+	if (m->m_flags & METH_FAST) {
+		return (*(fastmethod)m->m_meth)(self, args, n);
+    }
+	if (n == 0) {
+		return (*m->m_meth)(self, (object *)NULL);
+    }
+	if ((arg = newtupleobject(n)) == NULL) {
+		return NULL;
+    }
+	for (i = 0; i < n; i++) {
+		INCREF(args[i]);
+		settupleitem(arg, i, args[i]);
+	}
+	v = (*m->m_meth)(self, arg);
+	DECREF(arg);
+	return v;
+}
+
 /* Methods (the standard built-in methods, that is) */
 
 static void
@@ -61,7 +116,7 @@ meth_dealloc(methodobject *m)
 	if (m->m_self != NULL) {
 		DECREF(m->m_self);
     }
-	free((char *)m);
+	DEL(m);
 }
 
 static void
@@ -72,7 +127,7 @@ meth_print(methodobject *m, FILE *fp, int flags)
     }
 	else {
 		fprintf(fp, "<built-in method '%s' of some %s object>",
-				m->m_name, m->m_self->ob_type->tp_name);
+				m->m_name, TYPEOF(m->m_self)->tp_name);
     }
 }
 
@@ -86,7 +141,7 @@ meth_repr(methodobject *m)
     }
 	else {
 		sprintf(buf, "<built-in method '%.80s' of some %.80s object>",
-				m->m_name, m->m_self->ob_type->tp_name);
+				m->m_name, TYPEOF(m->m_self)->tp_name);
     }
 	return newstringobject(buf);
 }
@@ -108,14 +163,72 @@ typeobject Methodtype = {
 	0,							/*tp_as_mapping*/
 };
 
+/* Index of the names in a method table: a dictionary mapping each name to
+an unbound method object, see gettableindex().  The names in the table are
+replaced by their interned copies, which are never freed. */
+
+static object *
+makemethodindex(void *table)
+{
+	register struct methodlist *p;
+	object *index, *v;
+	int err;
+
+	if ((index = newdictobject()) == NULL) {
+		return NULL;
+    }
+	for (p = (struct methodlist *)table; p->ml_name != NULL; p++) {
+		if ((v = internstring(p->ml_name)) == NULL) {
+			break;
+        }
+		p->ml_name = getstringvalue(v);
+		DECREF(v);
+		if ((v = newmethodobject(p->ml_name, p->ml_meth, (object *)NULL,
+                                 p->ml_flags)) == NULL)
+        {
+			break;
+        }
+		err = dictinsert(index, p->ml_name, v);
+		DECREF(v);
+		if (err != 0) {
+			break;
+        }
+	}
+	if (p->ml_name != NULL) {
+		DECREF(index);
+		return NULL;
+	}
+	return index;
+}
+
+object *
+getmethodindex(struct methodlist *ml)
+{
+	return gettableindex((void *)ml, makemethodindex);
+}
+
 /* Find a method in a module's method table.  Usually called from an object's
 getattr method. */
 object *
 findmethod(struct methodlist *ml, object *op, char *name)
 {
-	for (; ml->ml_name != NULL; ml++) {
-		if (strcmp(name, ml->ml_name) == 0)
-			return newmethodobject(ml->ml_name, ml->ml_meth, op);
+	register struct methodlist *p;
+	methodobject *m;
+	object *index = getmethodindex(ml);
+
+	if (index != NULL) {
+		if ((m = (methodobject *)dictlookup(index, name)) == NULL) {
+			err_setstr(NameError, name);
+			return NULL;
+		}
+		return newmethodobject(m->m_name, m->m_meth, op, m->m_flags);
+	}
+	/* No memory for the index: search the table */
+	for (p = ml; p->ml_name != NULL; p++) {
+		if (strcmp(name, p->ml_name) == 0) {
+			return newmethodobject(p->ml_name, p->ml_meth, op,
+                                   p->ml_flags);
+        }
 	}
 	err_setstr(NameError, name);
 	return NULL;
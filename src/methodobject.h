@@ -8,21 +8,38 @@ extern "C" {
 /* Method object interface */
 
 extern typeobject Methodtype;
-#define is_methodobject(op) ((op)->ob_type == &Methodtype)
+#define is_methodobject(op) (TYPEOF(op) == &Methodtype)
 
 typedef object *(*method)(object *, object *);
 
-extern object *newmethodobject(char *, method, object *);
+/* A method with the METH_FAST flag is really a fastmethod: it gets its
+arguments as an array and a count, without a tuple.  It is cast to method
+when put in a method table. */
+typedef object *(*fastmethod)(object *, object **, int);
+
+#define METH_FAST	1
+
+extern object *newmethodobject(char *, method, object *, int);
 extern method getmethod(object *);
 extern object *getself(object *);
 
+/* Call a method object with self and either one argument object (a tuple
+for several arguments, or NULL for none), or an array of n arguments */
+extern object *callmethod(object *, object *, object *);
+extern object *fastcallmethod(object *, object *, object **, int);
+
 struct methodlist {
 	char    *ml_name;
 	method  ml_meth;
+	int     ml_flags;	/* METH_FAST or 0 */
 };
 
 extern object *findmethod(struct methodlist *, object *, char *);
 
+/* Return a dictionary mapping the names in a method table to method objects
+without a self, or NULL if it can't be made; don't modify it */
+extern object *getmethodindex(struct methodlist *);
+
 #ifdef __cplusplus
 }
 #endif
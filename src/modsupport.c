@@ -28,8 +28,11 @@ initmodule(char *name, struct methodlist *methods)
 	d = getmoduledict(m);
 	for (ml = methods; ml->ml_name != NULL; ml++) {
 		sprintf(namebuf, "%s.%s", name, ml->ml_name);
-		v = newmethodobject(strdup(namebuf), ml->ml_meth, (object *)NULL);
-		/* XXX The strdup'ed memory is never freed */
+		/* The interned name is never freed, so its value can be used */
+		if ((v = internstring(namebuf)) != NULL) {
+			v = newmethodobject(getstringvalue(v), ml->ml_meth,
+                                (object *)NULL, ml->ml_flags);
+        }
 		if (v == NULL || dictinsert(d, ml->ml_name, v) != 0) {
 			fprintf(stderr, "initializing module: %s\n", name);
 			fatal("can't initialize module");
@@ -64,7 +64,7 @@ module_dealloc(moduleobject *m)
 	if (m->md_dict != NULL) {
 		DECREF(m->md_dict);
     }
-	free((char *)m);
+	DEL(m);
 }
 
 static void
@@ -8,7 +8,7 @@ extern "C" {
 /* Module object interface */
 
 extern typeobject Moduletype;
-#define is_moduleobject(op) ((op)->ob_type == &Moduletype)
+#define is_moduleobject(op) (TYPEOF(op) == &Moduletype)
 
 extern object *newmoduleobject(char *);
 extern object *getmoduledict(object *);
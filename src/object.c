@@ -4,6 +4,7 @@
 
 #include "object.h"
 #include "stringobject.h"
+#include "iterobject.h"
 #include "errors.h"
 #include "malloc.h"
 #include "intrcheck.h"
@@ -19,7 +20,7 @@ long ref_total;
 object *
 newobject(typeobject *tp)
 {
-	object *op = (object *)malloc(tp->tp_basicsize);
+	object *op = (object *)mem_malloc(tp->tp_basicsize);
 
 	if (op == NULL) {
 		return err_nomem();
@@ -32,7 +33,7 @@ newobject(typeobject *tp)
 /* varobject *
 newvarobject(typeobject *tp, unsigned int size)
 {
-	varobject *op = (varobject *)malloc(tp->tp_basicsize
+	varobject *op = (varobject *)mem_malloc(tp->tp_basicsize
  					 + size * tp->tp_itemsize);
 	if (op == NULL) {
 		return err_nomem();
@@ -61,15 +62,15 @@ printobject(object *op, FILE *fp, int flags)
 			fprintf(fp, "<nil>");
 		}
 		else {
-			if (op->ob_refcnt <= 0) {
+			if (!IS_TAGGED(op) && op->ob_refcnt <= 0) {
 				fprintf(fp, "(refcnt %d):", op->ob_refcnt);
             }
-			if (op->ob_type->tp_print == NULL) {
+			if (TYPEOF(op)->tp_print == NULL) {
 				fprintf(fp, "<%s object at %lx>",
-                        op->ob_type->tp_name, (long)op);
+                        TYPEOF(op)->tp_name, (long)op);
 			}
 			else {
-				(*op->ob_type->tp_print)(op, fp, flags);
+				(*TYPEOF(op)->tp_print)(op, fp, flags);
 			}
 		}
 	}
@@ -94,14 +95,14 @@ reprobject(object *v)
 		if (v == NULL) {
 			w = newstringobject("<NULL>");
 		}
-		else if (v->ob_type->tp_repr == NULL) {
+		else if (TYPEOF(v)->tp_repr == NULL) {
 			char buf[100];
 			sprintf(buf, "<%.80s object at %lx>",
-                    v->ob_type->tp_name, (long)v);
+                    TYPEOF(v)->tp_name, (long)v);
 			w = newstringobject(buf);
 		}
 		else {
-			w = (*v->ob_type->tp_repr)(v);
+			w = (*TYPEOF(v)->tp_repr)(v);
 		}
 		if (StopPrint) {
 			XDECREF(w);
@@ -129,8 +130,8 @@ cmpobject(object *v, object *w)
 	if (w == NULL) {
 		return 1;
     }
-	if ((tp = v->ob_type) != w->ob_type) {
-		return strcmp(tp->tp_name, w->ob_type->tp_name);
+	if ((tp = TYPEOF(v)) != TYPEOF(w)) {
+		return strcmp(tp->tp_name, TYPEOF(w)->tp_name);
     }
 	if (tp->tp_compare == NULL) {
 		return (v < w) ? -1 : 1;
@@ -138,23 +139,64 @@ cmpobject(object *v, object *w)
 	return ((*tp->tp_compare)(v, w));
 }
 
+/* Objects that compare equal must have the same hash value.  The hash is
+   never -1; that is returned, with an exception set, for unhashable objects
+   and errors. */
+long
+hashobject(object *v)
+{
+	typeobject *tp = TYPEOF(v);
+
+	if (tp->tp_hash == NULL) {
+		err_setstr(TypeError, "unhashable object");
+		return -1;
+	}
+	return (*tp->tp_hash)(v);
+}
+
+/* An iterator over the items of v: a for loop takes its items from this
+   with tp_iternext, which is therefore checked here.  Sequences without a
+   tp_iter are indexed (see iterobject.c). */
+object *
+getiter(object *v)
+{
+	typeobject *tp = TYPEOF(v);
+	object *it;
+
+	if (tp->tp_iter != NULL) {
+		if ((it = (*tp->tp_iter)(v)) != NULL
+            && TYPEOF(it)->tp_iternext == NULL)
+        {
+			err_setstr(TypeError, "iter() returned non-iterator");
+			DECREF(it);
+			return NULL;
+		}
+		return it;
+    }
+	if (tp->tp_as_sequence != NULL) {
+		return newseqiterobject(v);
+    }
+	err_setstr(TypeError, "loop over non-sequence");
+	return NULL;
+}
+
 object *
 getattr(object *v, char *name)
 {
-	if (v->ob_type->tp_getattr == NULL) {
+	if (TYPEOF(v)->tp_getattr == NULL) {
 		err_setstr(TypeError, "attribute-less object");
 		return NULL;
 	}
 	else {
-		return (*v->ob_type->tp_getattr)(v, name);
+		return (*TYPEOF(v)->tp_getattr)(v, name);
 	}
 }
 
 int
 setattr(object *v, char *name, object *w)
 {
-	if (v->ob_type->tp_setattr == NULL) {
-		if (v->ob_type->tp_getattr == NULL) {
+	if (TYPEOF(v)->tp_setattr == NULL) {
+		if (TYPEOF(v)->tp_getattr == NULL) {
 			err_setstr(TypeError, "attribute-less object");
         }
 		else {
@@ -163,8 +205,85 @@ setattr(object *v, char *name, object *w)
 		return -1;
 	}
 	else {
-		return (*v->ob_type->tp_setattr)(v, name, w);
+		return (*TYPEOF(v)->tp_setattr)(v, name, w);
+	}
+}
+
+/* The table indexes are found by hashing the table's address, in an open
+   addressing hash table that doubles in size when it is two thirds full. */
+
+struct tableindex {
+	void	*ti_table;	/* NULL if the entry is free */
+	object	*ti_index;
+};
+
+static struct tableindex *tableindexes;
+static int ntableindexes, tableindexsize;
+
+static struct tableindex *
+findtableindex(void *table)
+{
+	unsigned long mask = tableindexsize - 1, i;
+
+	i = ((unsigned long)table >> 4 ^ (unsigned long)table >> 12) & mask;
+	while (tableindexes[i].ti_table != NULL
+           && tableindexes[i].ti_table != table)
+    {
+		i = (i + 1) & mask;
+    }
+	return &tableindexes[i];
+}
+
+static int
+growtableindexes(void)
+{
+	struct tableindex *old = tableindexes, *ti;
+	int oldsize = tableindexsize, size = oldsize == 0 ? 16 : 2 * oldsize;
+
+	if ((tableindexes = NEW(struct tableindex, size)) == NULL) {
+		tableindexes = old;
+		return -1;
+	}
+	tableindexsize = size;
+	for (int i = 0; i < size; i++) {
+		tableindexes[i].ti_table = NULL;
+    }
+	for (int i = 0; i < oldsize; i++) {
+		if (old[i].ti_table != NULL) {
+			ti = findtableindex(old[i].ti_table);
+			*ti = old[i];
+		}
+	}
+	XDEL(old);
+	return 0;
+}
+
+object *
+gettableindex(void *table, object *(*make)(void *))
+{
+	struct tableindex *ti;
+	object *index;
+
+	if (tableindexsize > 0) {
+		ti = findtableindex(table);
+		if (ti->ti_table != NULL) {
+			return ti->ti_index;
+        }
+	}
+	if (3 * (ntableindexes + 1) > 2 * tableindexsize
+        && growtableindexes() != 0)
+    {
+		return NULL;
+    }
+	if ((index = (*make)(table)) == NULL) {
+		err_clear();
+		return NULL;
 	}
+	ti = findtableindex(table);
+	ti->ti_table = table;
+	ti->ti_index = index;
+	ntableindexes++;
+	return index;
 }
 
 /* NoObject is usable as a non-NULL undefined value, used by the macro None.
@@ -7,6 +7,8 @@ extern "C" {
 
 #include <stdio.h>
 
+#include "pyconfig.h"
+
 #define NDEBUG
 
 /* Object and type object interface */
@@ -139,6 +141,9 @@ typedef object *(*getattrfunc)(object *, char *);
 typedef int 	(*setattrfunc)(object *, char *, object *);
 typedef int 	(*cmpfunc)(object *, object *);
 typedef 		object *(*reprfunc)(object *);
+typedef long	(*hashfunc)(object *);
+typedef object *(*getiterfunc)(object *);
+typedef object *(*iternextfunc)(object *);
 
 typedef struct _typeobject {
 	OB_VARHEAD
@@ -155,18 +160,60 @@ typedef struct _typeobject {
 	number_methods 		*tp_as_number;
 	sequence_methods 	*tp_as_sequence;
 	mapping_methods 	*tp_as_mapping;
+	/* Hash function; objects of types without one can't be dict keys */
+	hashfunc			tp_hash;
+	/* Methods found by tp_getattr through findmethod(), unless shadowed by
+	   other attributes; lets the interpreter call them without making a
+	   method object (see LOAD_METHOD in ceval.c) */
+	struct methodlist	*tp_methods;
+	/* Iteration (see getiter()): tp_iter returns an iterator over the
+	   object, and an iterator's tp_iternext returns its next item, or NULL
+	   with no exception set when there are no more */
+	getiterfunc			tp_iter;
+	iternextfunc		tp_iternext;
 } typeobject;
 
+/* 123456789-123456789-123456789-123456789-123456789-123456789-123456789-12
+
+Tagged integers
+===============
+
+When configured with --with-tagged-ints, USE_TAGGED_INTS is defined, and an
+integer that fits in a long less one bit is not allocated: its value is kept in
+the object pointer itself, shifted left one bit, with the lowest bit set (see
+intobject.c).  Objects are at least word aligned, so a pointer to a real object
+never has that bit set.  Such a pointer must never be dereferenced; TYPEOF()
+gives the type of any object and must be used instead of ob_type unless the
+object is known not to be an integer.  INCREF() and DECREF() leave tagged
+integers alone.  Without USE_TAGGED_INTS, IS_TAGGED() is always false and the
+compiler removes the extra tests. */
+
+#ifdef USE_TAGGED_INTS
+extern struct _typeobject Inttype;
+#define IS_TAGGED(op)	(((unsigned long)(op)) & 1)
+#define TYPEOF(op)		(IS_TAGGED(op) ? &Inttype : (op)->ob_type)
+#else
+#define IS_TAGGED(op)	0
+#define TYPEOF(op)		((op)->ob_type)
+#endif
+
 extern typeobject Typetype; /* The type of type objects */
-#define is_typeobject(op) ((op)->ob_type == &Typetype)
+#define is_typeobject(op) (TYPEOF(op) == &Typetype)
 
 /* Generic operations on objects */
 extern void 	printobject(object *, FILE *, int);
 extern object 	*reprobject(object *);
 extern int	 	cmpobject(object *, object *);
+extern long		hashobject(object *);
+extern object	*getiter(object *);
 extern object	*getattr(object *, char *);
 extern int 		setattr(object *, char *, object *);
 
+/* The index of a static table, such as a method or member list, made by
+   make(table) on first use and kept for good.  NULL, with no exception set,
+   if it can't be made; the caller then searches the table itself. */
+extern object	*gettableindex(void *table, object *(*make)(void *));
+
 /* Flag bits for printing: */
 #define PRINT_RAW	1	/* No string quotes etc. */
 
@@ -213,17 +260,17 @@ extern long ref_total;
 #ifndef TRACE_REFS
 #define NEWREF(op) (ref_total++, (op)->ob_refcnt = 1)
 #endif
-#define INCREF(op) (ref_total++, (op)->ob_refcnt++)
+#define INCREF(op) (IS_TAGGED(op) ? 0 : (ref_total++, (op)->ob_refcnt++))
 #define DECREF(op) \
-	if (--ref_total, --(op)->ob_refcnt > 0) \
+	if (IS_TAGGED(op) || (--ref_total, --(op)->ob_refcnt > 0)) \
 		; \
 	else \
 		DELREF(op)
 #else
 #define NEWREF(op) ((op)->ob_refcnt = 1)
-#define INCREF(op) ((op)->ob_refcnt++)
+#define INCREF(op) (IS_TAGGED(op) ? 0 : (op)->ob_refcnt++)
 #define DECREF(op) \
-	if (--(op)->ob_refcnt > 0) \
+	if (IS_TAGGED(op) || --(op)->ob_refcnt > 0) \
 		; \
 	else \
 		DELREF(op)
@@ -19,7 +19,10 @@ determined by the tp_basicsize field of the type object.
 
 NEWVAROBJ(type, typeobj, n) is similar but allocates a variable-size object
 with n extra items.  The size is computer as tp_basicsize plus n * tp_itemsize.
-This fills in the ob_size field as well. */
+This fills in the ob_size field as well.
+
+The memory comes from the small-object allocator (see malloc.h); a type's
+deallocator must release it with DEL(), never with free(). */
 
 extern object    *newobject(typeobject *);
 extern varobject *newvarobject(typeobject *, unsigned int);
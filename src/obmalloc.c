@@ -0,0 +1,483 @@
+/* Small-object allocator */
+
+/* Requests of up to SMALL_REQUEST_THRESHOLD bytes are rounded up to a
+   multiple of ALIGNMENT and served from pools of equal-sized blocks, one
+   size class per pool.  Pools are POOL_SIZE bytes and are carved out of
+   arenas of ARENA_SIZE bytes, which are mapped from the system aligned to
+   their size.  The arena of an address is thus found by masking it; a
+   small hash table of the live arenas tells whether an address came from
+   here at all, so DEL() can be used on memory from malloc() as well.
+   Larger requests go straight to malloc().
+
+   A freed block goes to the front of its pool's free list.  A pool whose
+   last block is freed goes back to its arena, where it can be reused for
+   any size class, and an arena all of whose pools are free is unmapped.
+   To make that likely, new pools are always taken from the arena with
+   the fewest free pools: the usable arenas are kept on a list sorted by
+   their number of free pools. */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include "malloc.h"
+
+#define ALIGNMENT_SHIFT 3
+#define ALIGNMENT (1 << ALIGNMENT_SHIFT)
+#define SMALL_REQUEST_THRESHOLD 256
+#define NCLASSES (SMALL_REQUEST_THRESHOLD / ALIGNMENT)
+#define CLASSSIZE(i) (((unsigned int)(i) + 1) << ALIGNMENT_SHIFT)
+
+#define POOL_SIZE 4096
+#define ARENA_SHIFT 18
+#define ARENA_SIZE ((uintptr_t)1 << ARENA_SHIFT)	/* 256 KB */
+#define POOLS_PER_ARENA (ARENA_SIZE / POOL_SIZE)
+
+#define ROUNDUP(n) (((n) + ALIGNMENT - 1) & ~(uintptr_t)(ALIGNMENT - 1))
+#define POOL_ADDR(p) ((struct pool *)((uintptr_t)(p) & ~(uintptr_t)(POOL_SIZE - 1)))
+#define ARENA_KEY(p) ((uintptr_t)(p) >> ARENA_SHIFT)
+
+typedef unsigned char block;
+
+/* A pool header sits at the start of its pool.  A pool with both free and
+   used blocks is on the usedpools list of its size class; a full pool is
+   on no list; an empty pool is on its arena's free list, linked through
+   p_next.  Blocks that were never used are not on the free list, they
+   start at offset p_nextoffset. */
+struct pool {
+	block *p_freeblock;		/* Free list of released blocks */
+	struct pool *p_next;
+	struct pool *p_prev;
+	struct arena *p_arena;
+	unsigned int p_count;		/* Blocks in use */
+	unsigned int p_szidx;		/* Size class */
+	unsigned int p_nextoffset;	/* First never-used block */
+	unsigned int p_maxnextoffset;	/* Last block that fits */
+};
+
+#define POOL_OVERHEAD ROUNDUP(sizeof(struct pool))
+
+/* The arena headers are kept apart from the arenas, so an empty arena is
+   not touched.  Pools that were never used are not on the free list
+   either; they start at a_nextpool. */
+struct arena {
+	block *a_address;
+	block *a_nextpool;		/* First never-used pool */
+	struct pool *a_freepools;	/* Empty pools */
+	unsigned int a_nfreepools;	/* Including the never-used ones */
+	struct arena *a_next;		/* Links in usable_arenas */
+	struct arena *a_prev;
+};
+
+static struct pool *usedpools[NCLASSES];
+static struct arena *usable_arenas;
+
+static struct arena **arenamap;	/* Open addressing, linear probing */
+static uintptr_t mapsize;	/* Power of two */
+static uintptr_t mapused;
+
+static long narenas, maxarenas, nallocated, nreleased;
+
+/* Arena table */
+
+#define MAPHASH(key) (((key) * 2654435761UL) & (mapsize - 1))
+
+static struct arena *
+findarena(ANY *p)
+{
+	uintptr_t key = ARENA_KEY(p), i;
+	struct arena *a;
+
+	if (mapsize == 0) {
+		return NULL;
+    }
+	for (i = MAPHASH(key); (a = arenamap[i]) != NULL; i = (i + 1) & (mapsize - 1)) {
+		if (ARENA_KEY(a->a_address) == key) {
+			return a;
+        }
+	}
+	return NULL;
+}
+
+static void
+mapinsert(struct arena *a)
+{
+	uintptr_t i = MAPHASH(ARENA_KEY(a->a_address));
+
+	while (arenamap[i] != NULL) {
+		i = (i + 1) & (mapsize - 1);
+    }
+	arenamap[i] = a;
+	mapused++;
+}
+
+/* Keep the table at most half full; returns -1 if it can't grow */
+static int
+mapreserve(void)
+{
+	struct arena **oldmap = arenamap;
+	uintptr_t oldsize = mapsize, newsize;
+
+	if (2 * (mapused + 1) <= mapsize) {
+		return 0;
+    }
+	newsize = mapsize == 0 ? 64 : 2 * mapsize;
+	arenamap = (struct arena **)calloc(newsize, sizeof(struct arena *));
+	if (arenamap == NULL) {
+		arenamap = oldmap;
+		return -1;
+	}
+	mapsize = newsize;
+	mapused = 0;
+	for (uintptr_t i = 0; i < oldsize; i++) {
+		if (oldmap[i] != NULL) {
+			mapinsert(oldmap[i]);
+        }
+	}
+	free((char *)oldmap);
+	return 0;
+}
+
+/* Remove an arena, moving back the entries after it that would otherwise
+   no longer be found */
+static void
+mapremove(struct arena *a)
+{
+	uintptr_t mask = mapsize - 1, i, j, h;
+
+	for (i = MAPHASH(ARENA_KEY(a->a_address)); arenamap[i] != a; i = (i + 1) & mask)
+		;
+	for (j = (i + 1) & mask; arenamap[j] != NULL; j = (j + 1) & mask) {
+		h = MAPHASH(ARENA_KEY(arenamap[j]->a_address));
+		/* Move it unless its home slot lies cyclically in (i, j] */
+		if (i <= j ? (i < h && h <= j) : (i < h || h <= j)) {
+			continue;
+        }
+		arenamap[i] = arenamap[j];
+		i = j;
+	}
+	arenamap[i] = NULL;
+	mapused--;
+}
+
+/* Arenas */
+
+static struct arena *
+newarena(void)
+{
+	struct arena *a;
+	block *p;
+	uintptr_t slack;
+
+	if (mapreserve() != 0 || (a = (struct arena *)malloc(sizeof(struct arena))) == NULL) {
+		return NULL;
+    }
+	/* Map twice the size and unmap what lies outside an aligned arena */
+	p = (block *)mmap(NULL, 2 * ARENA_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == (block *)MAP_FAILED) {
+		free((char *)a);
+		return NULL;
+	}
+	slack = ARENA_SIZE - ((uintptr_t)p & (ARENA_SIZE - 1));
+	if (slack == ARENA_SIZE) {
+		slack = 0;
+    }
+	if (slack > 0) {
+		munmap(p, slack);
+    }
+	munmap(p + slack + ARENA_SIZE, ARENA_SIZE - slack);
+	a->a_address = a->a_nextpool = p + slack;
+	a->a_freepools = NULL;
+	a->a_nfreepools = POOLS_PER_ARENA;
+	a->a_next = a->a_prev = NULL;
+	mapinsert(a);
+	nallocated++;
+	if (++narenas > maxarenas) {
+		maxarenas = narenas;
+    }
+	return a;
+}
+
+static void
+unlinkarena(struct arena *a)
+{
+	if (a->a_prev != NULL) {
+		a->a_prev->a_next = a->a_next;
+    }
+	else {
+		usable_arenas = a->a_next;
+    }
+	if (a->a_next != NULL) {
+		a->a_next->a_prev = a->a_prev;
+    }
+}
+
+static void
+freearena(struct arena *a)
+{
+	unlinkarena(a);
+	mapremove(a);
+	munmap(a->a_address, ARENA_SIZE);
+	free((char *)a);
+	narenas--;
+	nreleased++;
+}
+
+/* Pools */
+
+static void
+unlinkpool(struct pool *pool)
+{
+	if (pool->p_prev != NULL) {
+		pool->p_prev->p_next = pool->p_next;
+    }
+	else {
+		usedpools[pool->p_szidx] = pool->p_next;
+    }
+	if (pool->p_next != NULL) {
+		pool->p_next->p_prev = pool->p_prev;
+    }
+}
+
+static void
+linkpool(struct pool *pool)
+{
+	pool->p_prev = NULL;
+	pool->p_next = usedpools[pool->p_szidx];
+	if (pool->p_next != NULL) {
+		pool->p_next->p_prev = pool;
+    }
+	usedpools[pool->p_szidx] = pool;
+}
+
+/* Allocate from a fresh pool, the usedpools list of its class being empty */
+static ANY *
+newpool(unsigned int szidx)
+{
+	struct arena *a = usable_arenas;
+	struct pool *pool;
+	unsigned int size = CLASSSIZE(szidx);
+
+	if (a == NULL) {
+		if ((a = newarena()) == NULL) {
+			return NULL;
+        }
+		usable_arenas = a;
+	}
+	if (a->a_freepools != NULL) {
+		pool = a->a_freepools;
+		a->a_freepools = pool->p_next;
+	}
+	else {
+		pool = (struct pool *)a->a_nextpool;
+		a->a_nextpool += POOL_SIZE;
+		pool->p_arena = a;
+	}
+	/* The list stays sorted: the head only gets fewer free pools */
+	if (--a->a_nfreepools == 0) {
+		unlinkarena(a);
+    }
+	pool->p_szidx = szidx;
+	pool->p_count = 1;
+	pool->p_freeblock = NULL;
+	pool->p_nextoffset = POOL_OVERHEAD + size;
+	pool->p_maxnextoffset = POOL_SIZE - size;
+	linkpool(pool);
+	return (ANY *)pool + POOL_OVERHEAD;
+}
+
+/* Give an empty pool back to its arena */
+static void
+freepool(struct pool *pool)
+{
+	struct arena *a = pool->p_arena, *b;
+
+	pool->p_next = a->a_freepools;
+	a->a_freepools = pool;
+	if (++a->a_nfreepools == 1) {
+		/* It was full, so it has the fewest free pools of all */
+		a->a_prev = NULL;
+		a->a_next = usable_arenas;
+		if (a->a_next != NULL) {
+			a->a_next->a_prev = a;
+        }
+		usable_arenas = a;
+		return;
+	}
+	/* Keep the last usable arena even if it is empty, so that a program
+	   that allocates and frees one object doesn't map and unmap arenas */
+	if (a->a_nfreepools == POOLS_PER_ARENA
+        && (a->a_prev != NULL || a->a_next != NULL))
+    {
+		freearena(a);
+		return;
+	}
+	/* Move it towards the end of usable_arenas to keep the list sorted */
+	while ((b = a->a_next) != NULL && b->a_nfreepools < a->a_nfreepools) {
+		unlinkarena(a);
+		a->a_prev = b;
+		a->a_next = b->a_next;
+		if (b->a_next != NULL) {
+			b->a_next->a_prev = a;
+        }
+		b->a_next = a;
+	}
+}
+
+/* Interface */
+
+ANY *
+mem_malloc(size_t n)
+{
+	struct pool *pool;
+	block *bp;
+
+	if (n - 1 >= SMALL_REQUEST_THRESHOLD) {
+		return (ANY *)malloc(n);
+    }
+	pool = usedpools[(n - 1) >> ALIGNMENT_SHIFT];
+	if (pool == NULL) {
+		return newpool((unsigned int)((n - 1) >> ALIGNMENT_SHIFT));
+    }
+	pool->p_count++;
+	if ((bp = pool->p_freeblock) != NULL) {
+		pool->p_freeblock = *(block **)bp;
+		if (pool->p_freeblock != NULL
+            || pool->p_nextoffset <= pool->p_maxnextoffset)
+        {
+			return (ANY *)bp;
+        }
+	}
+	else {
+		bp = (block *)pool + pool->p_nextoffset;
+		pool->p_nextoffset += CLASSSIZE(pool->p_szidx);
+		if (pool->p_nextoffset <= pool->p_maxnextoffset) {
+			return (ANY *)bp;
+        }
+	}
+	/* The pool is full now */
+	unlinkpool(pool);
+	return (ANY *)bp;
+}
+
+void
+mem_free(ANY *p)
+{
+	struct pool *pool;
+	int wasfull;
+
+	if (p == NULL) {
+		return;
+    }
+	if (findarena(p) == NULL) {
+		free(p);
+		return;
+	}
+	pool = POOL_ADDR(p);
+	wasfull = pool->p_freeblock == NULL
+              && pool->p_nextoffset > pool->p_maxnextoffset;
+	*(block **)p = pool->p_freeblock;
+	pool->p_freeblock = (block *)p;
+	if (--pool->p_count == 0) {
+		if (!wasfull) {
+			unlinkpool(pool);
+        }
+		freepool(pool);
+	}
+	else if (wasfull) {
+		linkpool(pool);
+    }
+}
+
+/* A block that shrinks by less than a quarter stays where it is */
+ANY *
+mem_realloc(ANY *p, size_t n)
+{
+	ANY *q;
+	size_t size;
+
+	if (p == NULL) {
+		return mem_malloc(n);
+    }
+	if (findarena(p) == NULL) {
+		return (ANY *)realloc(p, n);
+    }
+	size = CLASSSIZE(POOL_ADDR(p)->p_szidx);
+	if (n <= size && 4 * n > 3 * size) {
+		return p;
+    }
+	if ((q = mem_malloc(n)) == NULL) {
+		/* Shrinking can't fail */
+		return n <= size ? p : NULL;
+	}
+	memcpy(q, p, n < size ? n : size);
+	mem_free(p);
+	return q;
+}
+
+/* Statistics */
+
+/* Walk the pools in use, counting the blocks of each size class */
+static void
+countblocks(long *pools, long *blocks)
+{
+	struct arena *a;
+	struct pool *pool;
+
+	for (int i = 0; i < NCLASSES; i++) {
+		pools[i] = blocks[i] = 0;
+    }
+	for (uintptr_t i = 0; i < mapsize; i++) {
+		if ((a = arenamap[i]) == NULL) {
+			continue;
+        }
+		for (block *p = a->a_address; p < a->a_nextpool; p += POOL_SIZE) {
+			pool = (struct pool *)p;
+			if (pool->p_count > 0) {
+				pools[pool->p_szidx]++;
+				blocks[pool->p_szidx] += pool->p_count;
+			}
+		}
+	}
+}
+
+void
+mem_getstats(struct memstats *ms)
+{
+	long pools[NCLASSES], blocks[NCLASSES];
+
+	countblocks(pools, blocks);
+	ms->ms_arenas = narenas;
+	ms->ms_maxarenas = maxarenas;
+	ms->ms_allocated = nallocated;
+	ms->ms_released = nreleased;
+	ms->ms_pools = ms->ms_blocks = ms->ms_bytes = 0;
+	for (int i = 0; i < NCLASSES; i++) {
+		ms->ms_pools += pools[i];
+		ms->ms_blocks += blocks[i];
+		ms->ms_bytes += blocks[i] * CLASSSIZE(i);
+	}
+}
+
+void
+mem_printstats(FILE *fp)
+{
+	long pools[NCLASSES], blocks[NCLASSES];
+	struct memstats ms;
+
+	countblocks(pools, blocks);
+	mem_getstats(&ms);
+	fprintf(fp, "size  pools   blocks    bytes\n");
+	for (int i = 0; i < NCLASSES; i++) {
+		if (pools[i] > 0) {
+			fprintf(fp, "%4u %6ld %8ld %8ld\n", CLASSSIZE(i), pools[i],
+                    blocks[i], blocks[i] * CLASSSIZE(i));
+        }
+	}
+	fprintf(fp, "%ld arenas (at most %ld, %ld allocated, %ld released)\n",
+            ms.ms_arenas, ms.ms_maxarenas, ms.ms_allocated, ms.ms_released);
+	fprintf(fp, "%ld pools, %ld blocks, %ld bytes in use\n",
+            ms.ms_pools, ms.ms_blocks, ms.ms_bytes);
+}
@@ -13,6 +13,8 @@ extern "C" {
 #define ROT_THREE	    3
 #define DUP_TOP		    4
 
+#define NOP			    9	/* Left over by the peephole optimizer */
+
 #define UNARY_POSITIVE	10
 #define UNARY_NEGATIVE	11
 #define UNARY_NOT	    12
@@ -26,6 +28,8 @@ extern "C" {
 #define BINARY_SUBTRACT	24
 #define BINARY_SUBSCR	25
 #define BINARY_CALL	    26
+#define CALL_RANGE	    27	/* BINARY_CALL making a for loop's sequence */
+#define GET_ITER	    28	/* Iterator over a for loop's sequence */
 
 #define SLICE		    30
 /* Also uses 31 - 33 */
@@ -43,6 +47,8 @@ extern "C" {
 #define PRINT_ITEM	    71
 #define PRINT_NEWLINE	72
 
+#define YIELD_VALUE	    79
+
 #define BREAK_LOOP	    80
 #define RAISE_EXCEPTION	81
 #define LOAD_LOCALS    	82
@@ -63,6 +69,9 @@ extern "C" {
 /* unused:		94 */
 #define STORE_ATTR	    95	/* Index in name list */
 #define DELETE_ATTR	    96	/* "" */
+#define LOAD_METHOD	    97	/* Index in name list */
+#define CALL_METHOD	    98	/* Number of arguments */
+#define CALL_FUNCTION	99	/* Number of arguments, at least 2 */
 
 #define LOAD_CONST	    100	/* Index in const list */
 #define LOAD_NAME	    101	/* Index in name list */
@@ -80,10 +89,22 @@ extern "C" {
 #define JUMP_ABSOLUTE	113	/* Target byte offset from beginning of code */
 #define FOR_LOOP	    114	/* Number of bytes to skip */
 
+#define LOAD_GLOBAL	    116	/* Index in name list */
+
+/* Superinstructions made by the peephole optimizer.  The instruction they
+   are fused with is left in place after them and is skipped over. */
+#define LOAD_NAME_ATTR	117	/* LOAD_NAME + LOAD_ATTR */
+#define LOAD_FAST_ATTR	118	/* LOAD_FAST + LOAD_ATTR */
+#define COMPARE_JUMP_IF_FALSE	119	/* COMPARE_OP + JUMP_IF_FALSE */
+
 #define SETUP_LOOP	    120	/* Target address (absolute) */
 #define SETUP_EXCEPT	121	/* "" */
 #define SETUP_FINALLY	122	/* "" */
 
+#define LOAD_FAST	    124	/* Local variable number */
+#define STORE_FAST	    125	/* Local variable number */
+#define DELETE_FAST	    126	/* Local variable number */
+
 #define SET_LINENO	    127	/* Current line number */
 
 /* Comparison operator codes (argument to COMPARE_OP) */
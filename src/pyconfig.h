@@ -0,0 +1,10 @@
+/* Generated automatically by configure */
+
+#ifndef Py_PYCONFIG_H
+#define Py_PYCONFIG_H
+
+
+
+
+
+#endif /* !Py_PYCONFIG_H */
@@ -34,6 +34,11 @@ main(int argc, char **argv)
 	char *filename = NULL;
 	FILE *fp = stdin;
 	
+	if (argc > 1 && strcmp(argv[1], "-O") == 0) {
+		optimizeflag = 1;
+		argc--;
+		argv++;
+	}
 	if (argc > 1 && strcmp(argv[1], "-") != 0) {
 		filename = argv[1];
     }
@@ -296,6 +301,10 @@ goaway(int sts)
 	fprintf(stderr, "[%ld refs]\n", ref_total);
 #endif
 
+#ifdef MALLOC_STATS
+	mem_printstats(stderr);
+#endif
+
 #ifdef TRACE_REFS
 	if (askyesno("Print left references?")) {
 		printrefs(stderr);
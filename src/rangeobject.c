@@ -0,0 +1,271 @@
+/* Range object implementation */
+
+#include <limits.h>
+
+#include "object.h"
+#include "objimpl.h"
+#include "intobject.h"
+#include "stringobject.h"
+#include "tupleobject.h"
+#include "rangeobject.h"
+#include "errors.h"
+#include "malloc.h"
+
+int
+getrangeargs(object **args, int nargs, long *pstart, long *pstep, int *plen)
+{
+	long ilow, ihigh, istep;
+	unsigned long n;
+	int i;
+
+	if (nargs < 1 || nargs > 3) {
+		err_setstr(TypeError, "range() requires 1-3 int arguments");
+		return -1;
+	}
+	for (i = 0; i < nargs; i++) {
+		if (!is_intobject(args[i])) {
+			err_setstr(TypeError, "range() requires 1-3 int arguments");
+			return -1;
+		}
+	}
+	if (nargs == 3) {
+		istep = getintvalue(args[2]);
+		--nargs;
+	}
+	else {
+		istep = 1;
+    }
+	ihigh = getintvalue(args[--nargs]);
+	if (nargs > 0) {
+		ilow = getintvalue(args[0]);
+    }
+	else {
+		ilow = 0;
+    }
+	if (istep == 0) {
+		err_setstr(RuntimeError, "zero step for range()");
+		return -1;
+	}
+	/* Unsigned arithmetic can't overflow, even for the widest ranges */
+	if (istep > 0 && ilow < ihigh) {
+		n = ((unsigned long)ihigh - (unsigned long)ilow - 1)
+            / (unsigned long)istep + 1;
+    }
+	else if (istep < 0 && ilow > ihigh) {
+		n = ((unsigned long)ilow - (unsigned long)ihigh - 1)
+            / (0UL - (unsigned long)istep) + 1;
+    }
+	else {
+		n = 0;
+    }
+	if (n > INT_MAX) {
+		err_setstr(OverflowError, "range() has too many items");
+		return -1;
+	}
+	*pstart = ilow;
+	*pstep = istep;
+	*plen = (int)n;
+	return 0;
+}
+
+object *
+newrangeobject(long start, long step, int len)
+{
+	rangeobject *r = NEWOBJ(rangeobject, &Rangetype);
+
+	if (r == NULL) {
+		return NULL;
+    }
+	r->r_start = start;
+	r->r_step = step;
+	r->r_len = len;
+	return (object *)r;
+}
+
+/* Methods */
+
+static void
+range_dealloc(rangeobject *r)
+{
+	DEL(r);
+}
+
+static object *
+range_repr(rangeobject *r)
+{
+	char buf[100];
+
+	sprintf(buf, "xrange(%ld, %ld, %ld)", r->r_start,
+            (long)((unsigned long)r->r_start
+                   + (unsigned long)r->r_len * (unsigned long)r->r_step),
+            r->r_step);
+	return newstringobject(buf);
+}
+
+static void
+range_print(rangeobject *r, FILE *fp, int flags)
+{
+	object *s = range_repr(r);
+
+	if (s != NULL) {
+		fputs(getstringvalue(s), fp);
+		DECREF(s);
+	}
+}
+
+/* Ranges compare like the lists they stand for */
+static int
+range_compare(rangeobject *v, rangeobject *w)
+{
+	int len = v->r_len < w->r_len ? v->r_len : w->r_len;
+
+	for (int i = 0; i < len; i++) {
+		long a = GETRANGEITEM(v, i), b = GETRANGEITEM(w, i);
+		if (a != b) {
+			return a < b ? -1 : 1;
+        }
+	}
+	return v->r_len - w->r_len;
+}
+
+static int
+range_length(rangeobject *r)
+{
+	return r->r_len;
+}
+
+static object *
+range_item(rangeobject *r, int i)
+{
+	if (i < 0 || i >= r->r_len) {
+		err_setstr(IndexError, "range index out of range");
+		return NULL;
+	}
+	return newintobject(GETRANGEITEM(r, i));
+}
+
+static object *
+range_slice(rangeobject *r, int ilow, int ihigh)
+{
+	if (ilow < 0) {
+		ilow = 0;
+    }
+	if (ihigh > r->r_len) {
+		ihigh = r->r_len;
+    }
+	if (ihigh < ilow) {
+		ihigh = ilow;
+    }
+	if (ilow == 0 && ihigh == r->r_len) {
+		INCREF(r);
+		return (object *)r;
+	}
+	return newrangeobject(GETRANGEITEM(r, ilow), r->r_step, ihigh - ilow);
+}
+
+static object *
+range_concat(rangeobject *r, object *w)
+{
+	err_setstr(TypeError, "can't concatenate ranges");
+	return NULL;
+}
+
+static sequence_methods range_as_sequence = {
+	(inquiry)range_length,		/*sq_length*/
+	(binaryfunc)range_concat,	/*sq_concat*/
+	0,							/*sq_repeat*/
+	(intargfunc)range_item,		/*sq_item*/
+	(intintargfunc)range_slice,	/*sq_slice*/
+	0,							/*sq_ass_item*/
+	0,							/*sq_ass_slice*/
+};
+
+/* Range iterators count from the start with the step, without indexing */
+
+typedef struct {
+	OB_HEAD
+	long it_next;
+	long it_step;
+	int it_left;
+} rangeiterobject;
+
+static void
+rangeiter_dealloc(rangeiterobject *it)
+{
+	DEL(it);
+}
+
+static object *
+rangeiter_iter(rangeiterobject *it)
+{
+	INCREF(it);
+	return (object *)it;
+}
+
+static object *
+rangeiter_next(rangeiterobject *it)
+{
+	long i = it->it_next;
+
+	if (it->it_left <= 0) {
+		return NULL;
+    }
+	it->it_left--;
+	it->it_next = (long)((unsigned long)i + (unsigned long)it->it_step);
+	return newintobject(i);
+}
+
+static typeobject Rangeitertype = {
+	OB_HEAD_INIT(&Typetype)
+	0,
+	"rangeiterator",
+	sizeof(rangeiterobject),
+	0,
+	(destructor)rangeiter_dealloc,	/*tp_dealloc*/
+	0,								/*tp_print*/
+	0,								/*tp_getattr*/
+	0,								/*tp_setattr*/
+	0,								/*tp_compare*/
+	0,								/*tp_repr*/
+	0,								/*tp_as_number*/
+	0,								/*tp_as_sequence*/
+	0,								/*tp_as_mapping*/
+	0,								/*tp_hash*/
+	0,								/*tp_methods*/
+	(getiterfunc)rangeiter_iter,	/*tp_iter*/
+	(iternextfunc)rangeiter_next,	/*tp_iternext*/
+};
+
+static object *
+range_iter(rangeobject *r)
+{
+	rangeiterobject *it = NEWOBJ(rangeiterobject, &Rangeitertype);
+
+	if (it == NULL) {
+		return NULL;
+    }
+	it->it_next = r->r_start;
+	it->it_step = r->r_step;
+	it->it_left = r->r_len;
+	return (object *)it;
+}
+
+typeobject Rangetype = {
+	OB_HEAD_INIT(&Typetype)
+	0,
+	"xrange",
+	sizeof(rangeobject),
+	0,
+	(destructor)range_dealloc,	/*tp_dealloc*/
+	(printfunc)range_print,		/*tp_print*/
+	0,							/*tp_getattr*/
+	0,							/*tp_setattr*/
+	(cmpfunc)range_compare,		/*tp_compare*/
+	(reprfunc)range_repr,		/*tp_repr*/
+	0,							/*tp_as_number*/
+	&range_as_sequence,			/*tp_as_sequence*/
+	0,							/*tp_as_mapping*/
+	0,							/*tp_hash*/
+	0,							/*tp_methods*/
+	(getiterfunc)range_iter,	/*tp_iter*/
+};
@@ -0,0 +1,42 @@
+#ifndef Py_RANGEOBJECT_H
+#define Py_RANGEOBJECT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Range object interface */
+
+/* 123456789-123456789-123456789-123456789-123456789-123456789-123456789-12
+
+A range object is an immutable sequence of the ints that range() would put in
+a list, computed as they are indexed.  xrange() returns one, and so does
+range() when it only supplies the sequence of a for loop (see CALL_RANGE in
+ceval.c).
+
+getrangeargs() parses the arguments of range(), an array of 1 to 3 ints, into
+a start, a step and a length; it returns 0, or -1 with an exception set. */
+
+typedef struct {
+	OB_HEAD
+	long r_start;
+	long r_step;
+	int r_len;
+} rangeobject;
+
+extern typeobject Rangetype;
+
+#define is_rangeobject(op) (TYPEOF(op) == &Rangetype)
+
+extern int getrangeargs(object **, int, long *, long *, int *);
+extern object *newrangeobject(long start, long step, int len);
+
+/* Macros, trading safety for speed */
+#define GETRANGELEN(op) ((op)->r_len)
+#define GETRANGEITEM(op, i) ((op)->r_start + (long)(i) * (op)->r_step)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !Py_RANGEOBJECT_H */
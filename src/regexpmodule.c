@@ -127,6 +127,11 @@ static typeobject Regexptype = {
 	0,								/*tp_setattr*/
 	0,								/*tp_compare*/
 	0,								/*tp_repr*/
+	0,								/*tp_as_number*/
+	0,								/*tp_as_sequence*/
+	0,								/*tp_as_mapping*/
+	0,								/*tp_hash*/
+	regexp_methods,					/*tp_methods*/
 };
 
 void
@@ -1,16 +1,19 @@
 /* String object implementation */
 
+#include <limits.h>
 #include <string.h>
 
 #include "object.h"
+#include "objimpl.h"
 #include "stringobject.h"
+#include "dictobject.h"
 #include "errors.h"
 #include "malloc.h"
 
 object *
 newsizedstringobject(char *str, int size)
 {
-	register stringobject *op = (stringobject *)malloc(sizeof(stringobject)
+	register stringobject *op = (stringobject *)mem_malloc(sizeof(stringobject)
                                  + size * sizeof(char));
 	if (op == NULL) {
 		return err_nomem();
@@ -18,6 +21,7 @@ newsizedstringobject(char *str, int size)
 	NEWREF(op);
 	op->ob_type = &Stringtype;
 	op->ob_size = size;
+	op->ob_shash = -1;
 	if (str != NULL) {
 		memcpy(op->ob_sval, str, size);
     }
@@ -35,7 +39,7 @@ object *
 newstringobject(char *str)
 {
 	register unsigned int size = strlen(str);
-	register stringobject *op = (stringobject *)malloc(sizeof(stringobject)
+	register stringobject *op = (stringobject *)mem_malloc(sizeof(stringobject)
                                  + size * sizeof(char));
 	if (op == NULL) {
 		return err_nomem();
@@ -43,6 +47,7 @@ newstringobject(char *str)
 	NEWREF(op);
 	op->ob_type = &Stringtype;
 	op->ob_size = size;
+	op->ob_shash = -1;
 	strcpy(op->ob_sval, str);
 	return (object *)op;
 }
@@ -97,41 +102,37 @@ stringprint(stringobject *op, FILE *fp, int flags)
 static object *
 stringrepr(register stringobject *op)
 {
-	/* XXX overflow? */
-	int newsize = 2 + 4 * op->ob_size * sizeof(char);
-	object *v = newsizedstringobject((char *)NULL, newsize);
+	stringbuilder sb;
+	register int i;
+	register char c;
 
-	if (v == NULL) {
-		return err_nomem();
-	}
-	else {
-		register int i;
-		register char c, *p;
-		NEWREF(v);
-		v->ob_type = &Stringtype;
-		((stringobject *)v)->ob_size = newsize;
-		p = ((stringobject *)v)->ob_sval;
-		*p++ = '\'';
-		for (i = 0; i < op->ob_size; i++) {
-			c = op->ob_sval[i];
-			if (c == '\'' || c == '\\') {
-				*p++ = '\\', *p++ = c;
-            }
-			else if (c < ' ' || c >= 0177) {
-				sprintf(p, "\\%03o", c & 0377);
-				while (*p != '\0') {
-					p++;
-                }
-			}
-			else {
-				*p++ = c;
-            }
+	if (sb_init(&sb, op->ob_size + 2) != 0) {
+		return NULL;
+    }
+	SB_PUTCHAR(&sb, '\'');
+	for (i = 0; i < op->ob_size; i++) {
+		if (SB_RESERVE(&sb, 4) != 0) { /* Room for the longest escape */
+			break;
+        }
+		c = op->ob_sval[i];
+		if (c == '\'' || c == '\\') {
+			SB_PUTCHAR(&sb, '\\');
+			SB_PUTCHAR(&sb, c);
 		}
-		*p++ = '\'';
-		*p = '\0';
-		resizestring(&v, (int)(p - ((stringobject *)v)->ob_sval));
-		return v;
+		else if (c < ' ' || c >= 0177) {
+			SB_PUTCHAR(&sb, '\\');
+			SB_PUTCHAR(&sb, '0' + ((c >> 6) & 03));
+			SB_PUTCHAR(&sb, '0' + ((c >> 3) & 07));
+			SB_PUTCHAR(&sb, '0' + (c & 07));
+		}
+		else {
+			SB_PUTCHAR(&sb, c);
+        }
 	}
+	if (SB_RESERVE(&sb, 1) == 0) {
+		SB_PUTCHAR(&sb, '\'');
+    }
+	return sb_finish(&sb);
 }
 
 static int
@@ -161,13 +162,14 @@ stringconcat(register stringobject *a, register object *bb)
 		return (object *)a;
 	}
 	size = a->ob_size + b->ob_size;
-	op = (stringobject *)malloc(sizeof(stringobject) + size * sizeof(char));
+	op = (stringobject *)mem_malloc(sizeof(stringobject) + size * sizeof(char));
 	if (op == NULL) {
 		return err_nomem();
     }
 	NEWREF(op);
 	op->ob_type = &Stringtype;
 	op->ob_size = size;
+	op->ob_shash = -1;
 	memcpy(op->ob_sval, a->ob_sval, (int)a->ob_size);
 	memcpy(op->ob_sval + a->ob_size, b->ob_sval, (int)b->ob_size);
 	op->ob_sval[size] = '\0';
@@ -190,13 +192,14 @@ stringrepeat(register stringobject *a, register int n)
 		INCREF(a);
 		return (object *)a;
 	}
-	op = (stringobject *)malloc(sizeof(stringobject) + size * sizeof(char));
+	op = (stringobject *)mem_malloc(sizeof(stringobject) + size * sizeof(char));
 	if (op == NULL) {
 		return err_nomem();
     }
 	NEWREF(op);
 	op->ob_type = &Stringtype;
 	op->ob_size = size;
+	op->ob_shash = -1;
 	for (i = 0; i < size; i += a->ob_size) {
 		memcpy(op->ob_sval+i, a->ob_sval, (int)a->ob_size);
     }
@@ -251,6 +254,12 @@ stringcompare(stringobject *a, stringobject *b)
 	return (len_a < len_b) ? -1 : (len_a > len_b) ? 1 : 0;
 }
 
+static long
+stringhash(stringobject *a)
+{
+	return GETSTRINGHASH(a);
+}
+
 static sequence_methods string_as_sequence = {
 	(inquiry)stringlength,		/*tp_length*/
 	(binaryfunc)stringconcat,	/*tp_concat*/
@@ -261,6 +270,79 @@ static sequence_methods string_as_sequence = {
 	0,							/*tp_ass_slice*/
 };
 
+/* String iterators give the characters as strings of length 1 */
+
+typedef struct {
+	OB_HEAD
+	stringobject *it_seq;	/* NULL once the end has been reached */
+	int it_index;
+} stringiterobject;
+
+static void
+stringiter_dealloc(stringiterobject *it)
+{
+	XDECREF(it->it_seq);
+	DEL(it);
+}
+
+static object *
+stringiter_iter(stringiterobject *it)
+{
+	INCREF(it);
+	return (object *)it;
+}
+
+static object *
+stringiter_next(stringiterobject *it)
+{
+	stringobject *op = it->it_seq;
+
+	if (op == NULL) {
+		return NULL;
+    }
+	if (it->it_index < op->ob_size) {
+		return newsizedstringobject(op->ob_sval + it->it_index++, 1);
+    }
+	it->it_seq = NULL;
+	DECREF(op);
+	return NULL;
+}
+
+static typeobject Stringitertype = {
+	OB_HEAD_INIT(&Typetype)
+	0,
+	"stringiterator",
+	sizeof(stringiterobject),
+	0,
+	(destructor)stringiter_dealloc,	/*tp_dealloc*/
+	0,								/*tp_print*/
+	0,								/*tp_getattr*/
+	0,								/*tp_setattr*/
+	0,								/*tp_compare*/
+	0,								/*tp_repr*/
+	0,								/*tp_as_number*/
+	0,								/*tp_as_sequence*/
+	0,								/*tp_as_mapping*/
+	0,								/*tp_hash*/
+	0,								/*tp_methods*/
+	(getiterfunc)stringiter_iter,	/*tp_iter*/
+	(iternextfunc)stringiter_next,	/*tp_iternext*/
+};
+
+static object *
+string_iter(stringobject *op)
+{
+	stringiterobject *it = NEWOBJ(stringiterobject, &Stringitertype);
+
+	if (it == NULL) {
+		return NULL;
+    }
+	INCREF(op);
+	it->it_seq = op;
+	it->it_index = 0;
+	return (object *)it;
+}
+
 typeobject Stringtype = {
 	OB_HEAD_INIT(&Typetype)
 	0,
@@ -276,6 +358,9 @@ typeobject Stringtype = {
 	0,								/*tp_as_number*/
 	&string_as_sequence,			/*tp_as_sequence*/
 	0,								/*tp_as_mapping*/
+	(hashfunc)stringhash,			/*tp_hash*/
+	0,								/*tp_methods*/
+	(getiterfunc)string_iter,		/*tp_iter*/
 };
 
 void
@@ -315,7 +400,7 @@ resizestring(object **pv, int newsize)
 	--ref_total;
 #endif
 	UNREF(v);
-	*pv = (object *)realloc((char *)v, sizeof(stringobject)
+	*pv = (object *)mem_realloc((char *)v, sizeof(stringobject)
                              + newsize * sizeof(char));
 	if (*pv == NULL) {
 		DEL(v);
@@ -325,6 +410,188 @@ resizestring(object **pv, int newsize)
 	NEWREF(*pv);
 	sv = (stringobject *)*pv;
 	sv->ob_size = newsize;
+	sv->ob_shash = -1;
 	sv->ob_sval[newsize] = '\0';
 	return 0;
 }
+
+/* String builders, see stringobject.h */
+
+static int
+sb_fail(stringbuilder *sb)
+{
+	XDECREF(sb->sb_string);
+	sb->sb_string = NULL;
+	sb->sb_len = sb->sb_size = 0;
+	return -1;
+}
+
+int
+sb_init(stringbuilder *sb, int size)
+{
+	if (size < 16) {
+		size = 16;
+    }
+	sb->sb_len = 0;
+	sb->sb_size = size;
+	sb->sb_string = newsizedstringobject((char *)NULL, size);
+	if (sb->sb_string == NULL) {
+		return sb_fail(sb);
+    }
+	return 0;
+}
+
+/* Make room for n more characters, at least doubling the size */
+int
+sb_grow(stringbuilder *sb, int n)
+{
+	int need = sb->sb_len + n, size = sb->sb_size;
+
+	if (sb->sb_string == NULL) {
+		return -1;
+    }
+	if (n < 0 || need < 0) {
+		err_nomem();
+		return sb_fail(sb);
+	}
+	if (need <= size) {
+		return 0;
+    }
+	size = size < INT_MAX / 2 ? 2 * size : INT_MAX;
+	if (size < need) {
+		size = need;
+    }
+	if (resizestring(&sb->sb_string, size) != 0) {
+		return sb_fail(sb); /* The string is gone */
+    }
+	sb->sb_size = size;
+	return 0;
+}
+
+int
+sb_addchars(stringbuilder *sb, char *s, int n)
+{
+	if (sb->sb_string == NULL || SB_RESERVE(sb, n) != 0) {
+		return -1;
+    }
+	memcpy(GETSTRINGVALUE((stringobject *)sb->sb_string) + sb->sb_len, s, n);
+	sb->sb_len += n;
+	return 0;
+}
+
+int
+sb_addstring(stringbuilder *sb, object *v)
+{
+	if (v == NULL) {
+		return sb_fail(sb);
+    }
+	if (!is_stringobject(v)) {
+		err_badcall();
+		return sb_fail(sb);
+	}
+	return sb_addchars(sb, GETSTRINGVALUE((stringobject *)v),
+                       ((stringobject *)v)->ob_size);
+}
+
+int
+sb_addrepr(stringbuilder *sb, object *v)
+{
+	object *w;
+	int err;
+
+	if (sb->sb_string == NULL) {
+		return -1;
+    }
+	w = reprobject(v);
+	err = sb_addstring(sb, w);
+	XDECREF(w);
+	return err;
+}
+
+object *
+sb_finish(stringbuilder *sb)
+{
+	object *v = sb->sb_string;
+
+	if (v == NULL) {
+		return NULL;
+    }
+	sb->sb_string = NULL;
+	if (sb->sb_len < sb->sb_size && resizestring(&v, sb->sb_len) != 0) {
+		return NULL;
+    }
+	return v;
+}
+
+/* The hash function used by dictionaries.  Each character is mixed in by
+   a multiplication, so that every character affects all bits of the result;
+   the old shift-and-add hash gave many collisions between keys that differ
+   only in a few digits, as in generated names.  The first character is
+   added an extra time shifted by 7 to avoid hashing single-character keys
+   (often heavily used variables) too close together.  All arithmetic
+   ignores overflow.  The result is never -1, which marks an uncached hash. */
+long
+hashsizedstring(char *str, int size)
+{
+	register unsigned char *p = (unsigned char *)str;
+	register unsigned long sum = *p << 7;
+	register int len = size;
+	register long x;
+
+	while (--len >= 0) {
+		sum = (1000003 * sum) ^ *p++;
+    }
+	sum ^= size;
+	x = (long)sum;
+	if (x == -1) {
+		x = -2;
+    }
+	return x;
+}
+
+/* The intern table maps the value of every interned string to the one
+   stringobject holding it.  Interned strings are never deallocated, so
+   their value pointers may be kept around as C strings; two interned
+   strings are equal if and only if they are the same object. */
+
+static object *interned;
+
+object *
+internstring(char *str)
+{
+	register object *v;
+
+	if (interned == NULL) {
+		if ((interned = newdictobject()) == NULL) {
+			return NULL;
+        }
+	}
+	if ((v = dictlookup(interned, str)) != NULL) {
+		INCREF(v);
+		return v;
+	}
+	if ((v = newstringobject(str)) == NULL) {
+		return NULL;
+    }
+	if (dict2insert(interned, v, v) != 0) {
+		DECREF(v);
+		return NULL;
+	}
+	return v;
+}
+
+long
+getstringhash(register object *op)
+{
+	register stringobject *sv;
+
+	if (!is_stringobject(op)) {
+		err_badcall();
+		return -1;
+	}
+	sv = (stringobject *)op;
+	if (sv->ob_shash == -1) {
+		sv->ob_shash = hashsizedstring(sv->ob_sval, (int)sv->ob_size);
+    }
+	return sv->ob_shash;
+}
@@ -14,6 +14,11 @@ reserved at the end to ensure it is zero-terminated, but a size is present so
 strings with null bytes in them can be represented.  This is an immutable
 object type.
 
+The hash value used by dictionary lookups is computed the first time it is
+needed and cached in ob_shash; -1 means it hasn't been computed yet.  Code
+that fills in a fresh string's characters after creation must do so before
+the string is used as a dictionary key.
+
 There are functions to create new string objects, to test an object for string-
 ness, and to get the string value.  The latter function returns a null pointer
 if the object is not of the proper type.  There is a variant that takes an
@@ -24,11 +29,12 @@ that none of the functions should be applied to nil objects.*/
 
 typedef struct {
 	OB_VARHEAD
+	long ob_shash;
 	char ob_sval[1];
 } stringobject;
 
 extern typeobject Stringtype;
-#define is_stringobject(op) ((op)->ob_type == &Stringtype)
+#define is_stringobject(op) (TYPEOF(op) == &Stringtype)
 
 extern object *newsizedstringobject(char *, int);
 extern object *newstringobject(char *);
@@ -36,9 +42,42 @@ extern unsigned int getstringsize(object *);
 extern char *getstringvalue(object *);
 extern void joinstring(object **, object *);
 extern int resizestring(object **, int);
+extern object *internstring(char *);
+extern long hashsizedstring(char *, int);
+extern long getstringhash(object *);
+
+/* A string builder makes a string of a length not known in advance, such
+as a repr(), in linear time.  The string is filled in place and grows to
+twice its size whenever it is full; sb_finish() shrinks it to the length
+filled in and returns it.  The functions return 0, or -1 with an exception
+set; after an error the builder holds nothing and the rest of the calls do
+nothing but return -1, so that only the result of sb_finish() (NULL) must
+be checked.  sb_addstring() takes a string or NULL, the result of a failed
+call, and doesn't consume it.  SB_PUTCHAR() adds one character, for which
+there must be room made by SB_RESERVE(). */
+
+typedef struct {
+	object	*sb_string;	/* NULL after an error */
+	int		sb_len;		/* number of characters filled in */
+	int		sb_size;	/* number of characters there is room for */
+} stringbuilder;
+
+extern int sb_init(stringbuilder *, int);
+extern int sb_grow(stringbuilder *, int);
+extern int sb_addchars(stringbuilder *, char *, int);
+extern int sb_addstring(stringbuilder *, object *);
+extern int sb_addrepr(stringbuilder *, object *);
+extern object *sb_finish(stringbuilder *);
+
+#define SB_RESERVE(sb, n) \
+	((sb)->sb_len + (n) <= (sb)->sb_size ? 0 : sb_grow((sb), (n)))
+#define SB_PUTCHAR(sb, c) \
+	(GETSTRINGVALUE((stringobject *)(sb)->sb_string)[(sb)->sb_len++] = (c))
 
-/* Macro, trading safety for speed */
+/* Macros, trading safety for speed */
 #define GETSTRINGVALUE(op) ((op)->ob_sval)
+#define GETSTRINGHASH(op) \
+	((op)->ob_shash != -1 ? (op)->ob_shash : getstringhash((object *)(op)))
 
 #ifdef __cplusplus
 }
@@ -6,146 +6,191 @@
 #include "intobject.h"
 #include "floatobject.h"
 #include "stringobject.h"
+#include "dictobject.h"
 #include "errors.h"
 #include "structmember.h"
 
-object *
-getmember(char *addr, struct memberlist *mlist, char *name)
+/* The members of each list are indexed by name in a dictionary, see
+gettableindex(), which maps the name to the member's position in the list. */
+
+static object *
+makememberindex(void *table)
+{
+	struct memberlist *mlist = (struct memberlist *)table;
+	object *index, *v;
+	int i;
+
+	if ((index = newdictobject()) == NULL) {
+		return NULL;
+    }
+	for (i = 0; mlist[i].name != NULL; i++) {
+		if ((v = newintobject((long)i)) == NULL) {
+			break;
+        }
+		if (dictinsert(index, mlist[i].name, v) != 0) {
+			DECREF(v);
+			break;
+		}
+		DECREF(v);
+	}
+	if (mlist[i].name != NULL) {
+		DECREF(index);
+		return NULL;
+	}
+	return index;
+}
+
+/* Return the member called name, or NULL if there is none */
+static struct memberlist *
+findmember(struct memberlist *mlist, char *name)
 {
 	struct memberlist *l;
-	
+	object *index = gettableindex((void *)mlist, makememberindex), *v;
+
+	if (index != NULL) {
+		v = dictlookup(index, name);
+		return v == NULL ? NULL : &mlist[getintvalue(v)];
+	}
+	/* No memory for the index: search the list */
 	for (l = mlist; l->name != NULL; l++) {
 		if (strcmp(l->name, name) == 0) {
-			object *v;
-			addr += l->offset;
-			switch (l->type) {
-				case T_SHORT:
-					v = newintobject((long)*(short*)addr);
-					break;
-
-				case T_INT:
-					v = newintobject((long)*(int*)addr);
-					break;
-
-				case T_LONG:
-					v = newintobject(*(long*)addr);
-					break;
-
-				case T_FLOAT:
-					v = newfloatobject((double)*(float*)addr);
-					break;
-
-				case T_DOUBLE:
-					v = newfloatobject(*(double*)addr);
-					break;
-
-				case T_STRING:
-					if (*(char**)addr == NULL) {
-						INCREF(None);
-						v = None;
-					}
-					else {
-						v = newstringobject(*(char**)addr);
-                    }
-					break;
-
-				case T_OBJECT:
-					v = *(object **)addr;
-					if (v == NULL) {
-						v = None;
-                    }
-					INCREF(v);
-					break;
-
-				default:
-					err_setstr(SystemError, "bad memberlist type");
-					v = NULL;
-			}
-			return v;
-		}
+			return l;
+        }
 	}
-	
-	err_setstr(NameError, name);
 	return NULL;
 }
 
+object *
+getmember(char *addr, struct memberlist *mlist, char *name)
+{
+	struct memberlist *l = findmember(mlist, name);
+	object *v;
+	
+	if (l == NULL) {
+		err_setstr(NameError, name);
+		return NULL;
+	}
+	addr += l->offset;
+	switch (l->type) {
+		case T_SHORT:
+			v = newintobject((long)*(short*)addr);
+			break;
+
+		case T_INT:
+			v = newintobject((long)*(int*)addr);
+			break;
+
+		case T_LONG:
+			v = newintobject(*(long*)addr);
+			break;
+
+		case T_FLOAT:
+			v = newfloatobject((double)*(float*)addr);
+			break;
+
+		case T_DOUBLE:
+			v = newfloatobject(*(double*)addr);
+			break;
+
+		case T_STRING:
+			if (*(char**)addr == NULL) {
+				INCREF(None);
+				v = None;
+			}
+			else {
+				v = newstringobject(*(char**)addr);
+            }
+			break;
+
+		case T_OBJECT:
+			v = *(object **)addr;
+			if (v == NULL) {
+				v = None;
+            }
+			INCREF(v);
+			break;
+
+		default:
+			err_setstr(SystemError, "bad memberlist type");
+			v = NULL;
+	}
+	return v;
+}
+
 int
 setmember(char *addr, struct memberlist *mlist, char *name, object *v)
 {
-	struct memberlist *l;
+	struct memberlist *l = findmember(mlist, name);
 	
-	for (l = mlist; l->name != NULL; l++) {
-		if (strcmp(l->name, name) == 0) {
-			if (l->readonly || l->type == T_STRING) {
-				err_setstr(RuntimeError, "readonly attribute");
+	if (l == NULL) {
+		err_setstr(NameError, name);
+		return -1;
+	}
+	if (l->readonly || l->type == T_STRING) {
+		err_setstr(RuntimeError, "readonly attribute");
+		return -1;
+	}
+	addr += l->offset;
+	switch (l->type) {
+		case T_SHORT:
+			if (!is_intobject(v)) {
+				err_badarg();
 				return -1;
 			}
-			addr += l->offset;
-			switch (l->type) {
-				case T_SHORT:
-					if (!is_intobject(v)) {
-						err_badarg();
-						return -1;
-					}
-					*(short*)addr = getintvalue(v);
-					break;
-
-				case T_INT:
-					if (!is_intobject(v)) {
-						err_badarg();
-						return -1;
-					}
-					*(int*)addr = getintvalue(v);
-					break;
-
-				case T_LONG:
-					if (!is_intobject(v)) {
-						err_badarg();
-						return -1;
-					}
-					*(long*)addr = getintvalue(v);
-					break;
-
-				case T_FLOAT:
-					if (is_intobject(v)) {
-						*(float*)addr = getintvalue(v);
-                    }
-					else if (is_floatobject(v)) {
-						*(float*)addr = getfloatvalue(v);
-                    }
-					else {
-						err_badarg();
-						return -1;
-					}
-					break;
-
-				case T_DOUBLE:
-					if (is_intobject(v)) {
-						*(double*)addr = getintvalue(v);
-                    }
-					else if (is_floatobject(v)) {
-						*(double*)addr = getfloatvalue(v);
-                    }
-					else {
-						err_badarg();
-						return -1;
-					}
-					break;
-
-				case T_OBJECT:
-					XDECREF(*(object **)addr);
-					XINCREF(v);
-					*(object **)addr = v;
-					break;
-
-				default:
-					err_setstr(SystemError, "bad memberlist type");
-					return -1;
+			*(short*)addr = getintvalue(v);
+			break;
+
+		case T_INT:
+			if (!is_intobject(v)) {
+				err_badarg();
+				return -1;
 			}
-			return 0;
-		}
+			*(int*)addr = getintvalue(v);
+			break;
+
+		case T_LONG:
+			if (!is_intobject(v)) {
+				err_badarg();
+				return -1;
+			}
+			*(long*)addr = getintvalue(v);
+			break;
+
+		case T_FLOAT:
+			if (is_intobject(v)) {
+				*(float*)addr = getintvalue(v);
+            }
+			else if (is_floatobject(v)) {
+				*(float*)addr = getfloatvalue(v);
+            }
+			else {
+				err_badarg();
+				return -1;
+			}
+			break;
+
+		case T_DOUBLE:
+			if (is_intobject(v)) {
+				*(double*)addr = getintvalue(v);
+            }
+			else if (is_floatobject(v)) {
+				*(double*)addr = getfloatvalue(v);
+            }
+			else {
+				err_badarg();
+				return -1;
+			}
+			break;
+
+		case T_OBJECT:
+			XDECREF(*(object **)addr);
+			XINCREF(v);
+			*(object **)addr = v;
+			break;
+
+		default:
+			err_setstr(SystemError, "bad memberlist type");
+			return -1;
 	}
-	
-	err_setstr(NameError, name);
-	return -1;
+	return 0;
 }
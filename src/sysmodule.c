@@ -2,8 +2,13 @@
 
 /* Various bits of information used by the interpreter are collected in
 module 'sys'.
-Function member:
+Function members:
 	- exit(sts): call (C, POSIX) exit(sts)
+	- mallocstats(): statistics of the small-object allocator, a tuple of
+	  (arenas, most arenas, arenas mapped, arenas unmapped, pools, blocks,
+	  bytes); see struct memstats in malloc.h
+	- clearfreelists(): free the frames, floats and tuples kept for reuse, and
+	  return how many there were
 Data members:
 	- stdin, stdout, stderr: standard file objects
 	- modules: the table of modules (dictionary)
@@ -14,7 +19,10 @@ Data members:
 #include <string.h>
 
 #include "object.h"
+#include "intobject.h"
+#include "floatobject.h"
 #include "stringobject.h"
+#include "tupleobject.h"
 #include "listobject.h"
 #include "dictobject.h"
 #include "methodobject.h"
@@ -25,6 +33,9 @@ Data members:
 #include "import.h"
 #include "modsupport.h"
 #include "pythonrun.h"
+#include "compile.h"	/* For ceval.h */
+#include "ceval.h"
+#include "frameobject.h"
 
 /* Define delimiter used in $PYTHONPATH */
 #define DELIM ':'
@@ -76,8 +87,78 @@ sys_exit(object *self, object *args)
 	/* NOTREACHED */
 }
 
+static object *
+sys_mallocstats(object *self, object *args)
+{
+	struct memstats ms;
+	object *v;
+
+	if (!getnoarg(args)) {
+		return NULL;
+    }
+	mem_getstats(&ms);
+	v = newtupleobject(7);
+	if (v == NULL) {
+		return NULL;
+    }
+#define SET(i, ms_member) settupleitem(v, i, newintobject(ms.ms_member))
+	SET(0, ms_arenas);
+	SET(1, ms_maxarenas);
+	SET(2, ms_allocated);
+	SET(3, ms_released);
+	SET(4, ms_pools);
+	SET(5, ms_blocks);
+	SET(6, ms_bytes);
+#undef SET
+	if (err_occurred()) {
+		DECREF(v);
+		return NULL;
+	}
+	return v;
+}
+
+static object *
+sys_clearfreelists(object *self, object *args)
+{
+	if (!getnoarg(args)) {
+		return NULL;
+    }
+	return newintobject((long)(clearframefreelist() + clearfloatfreelist()
+                               + cleartuplefreelists()));
+}
+
+static object *
+sys_getrecursionlimit(object *self, object *args)
+{
+	if (!getnoarg(args)) {
+		return NULL;
+    }
+	return newintobject((long)getrecursionlimit());
+}
+
+static object *
+sys_setrecursionlimit(object *self, object *args)
+{
+	int limit;
+
+	if (!getintarg(args, &limit)) {
+		return NULL;
+    }
+	if (limit < 1) {
+		err_setstr(RuntimeError, "recursion limit must be positive");
+		return NULL;
+	}
+	setrecursionlimit(limit);
+	INCREF(None);
+	return None;
+}
+
 static struct methodlist sys_methods[] = {
 	{"exit",	sys_exit},
+	{"mallocstats",	sys_mallocstats},
+	{"clearfreelists", sys_clearfreelists},
+	{"getrecursionlimit", sys_getrecursionlimit},
+	{"setrecursionlimit", sys_setrecursionlimit},
 	{NULL,		NULL}	/* sentinel */
 };
 
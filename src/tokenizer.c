@@ -169,7 +169,7 @@ tok_nextc(register struct tok_state *tok)
 				been_here++;
 			}
 			if (tok->buf != NULL) {
-				free(tok->buf);
+				DEL(tok->buf);
             }
 			tok->buf = readline(tok->prompt);
 			(void)intrcheck(); /* Clear pending interrupt */
@@ -62,7 +62,7 @@ static typeobject Tracebacktype = {
 	0,							/*tp_as_mapping*/
 };
 
-#define is_tracebackobject(v) ((v)->ob_type == &Tracebacktype)
+#define is_tracebackobject(v) (TYPEOF(v) == &Tracebacktype)
 
 static tracebackobject *
 newtracebackobject(tracebackobject *next, frameobject *frame, int lasti,
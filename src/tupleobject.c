@@ -7,6 +7,17 @@
 #include "errors.h"
 #include "malloc.h"
 
+/* Freed tuples of up to MAXSAVESIZE items are kept for reuse, on a free
+   list per size linked through ob_item[0], at most MAXSAVEDTUPLES of each
+   size.  The empty tuple is made once and then shared. */
+
+#define MAXSAVESIZE 20
+#define MAXSAVEDTUPLES 2000
+
+static tupleobject *free_tuples[MAXSAVESIZE + 1];
+static int numfree[MAXSAVESIZE + 1];
+static tupleobject *empty_tuple;
+
 object *
 newtupleobject(register int size)
 {
@@ -17,19 +28,51 @@ newtupleobject(register int size)
 		err_badcall();
 		return NULL;
 	}
-	op = (tupleobject *)malloc(sizeof(tupleobject) + size * sizeof(object *));
-	if (op == NULL) {
-		return err_nomem();
-    }
+	if (size == 0 && empty_tuple != NULL) {
+		INCREF(empty_tuple);
+		return (object *)empty_tuple;
+	}
+	if (size <= MAXSAVESIZE && (op = free_tuples[size]) != NULL) {
+		free_tuples[size] = (tupleobject *)op->ob_item[0];
+		numfree[size]--;
+	}
+	else {
+		op = (tupleobject *)mem_malloc(sizeof(tupleobject)
+                                       + size * sizeof(object *));
+		if (op == NULL) {
+			return err_nomem();
+        }
+	}
 	NEWREF(op);
 	op->ob_type = &Tupletype;
 	op->ob_size = size;
 	for (i = 0; i < size; i++) {
 		op->ob_item[i] = NULL;
     }
+	if (size == 0) {
+		empty_tuple = op;
+		INCREF(op);
+	}
 	return (object *)op;
 }
 
+int
+cleartuplefreelists(void)
+{
+	int n = 0;
+	tupleobject *op;
+
+	for (int size = 1; size <= MAXSAVESIZE; size++) {
+		while ((op = free_tuples[size]) != NULL) {
+			free_tuples[size] = (tupleobject *)op->ob_item[0];
+			DEL(op);
+		}
+		n += numfree[size];
+		numfree[size] = 0;
+	}
+	return n;
+}
+
 int
 gettuplesize(register object *op)
 {
@@ -95,7 +138,16 @@ tupledealloc(register tupleobject *op)
 			DECREF(op->ob_item[i]);
         }
 	}
-	free((ANY *)op);
+	if (op->ob_size > 0 && op->ob_size <= MAXSAVESIZE
+        && numfree[op->ob_size] < MAXSAVEDTUPLES)
+    {
+		op->ob_item[0] = (object *)free_tuples[op->ob_size];
+		free_tuples[op->ob_size] = op;
+		numfree[op->ob_size]++;
+	}
+	else {
+		DEL(op);
+    }
 }
 
 static void
@@ -117,28 +169,23 @@ tupleprint(tupleobject *op, FILE *fp, int flags)
 object *
 tuplerepr(tupleobject *v)
 {
-	object *s = newstringobject("("), *t, *comma = newstringobject(", ");
+	stringbuilder sb;
 
-	for (int i = 0; i < v->ob_size && s != NULL; i++) {
+	sb_init(&sb, 2 + 4 * v->ob_size);
+	sb_addchars(&sb, "(", 1);
+	for (int i = 0; i < v->ob_size; i++) {
 		if (i > 0) {
-			joinstring(&s, comma);
+			sb_addchars(&sb, ", ", 2);
         }
-		t = reprobject(v->ob_item[i]);
-		joinstring(&s, t);
-		if (t != NULL) {
-			DECREF(t);
+		if (sb_addrepr(&sb, v->ob_item[i]) != 0) {
+			break;
         }
 	}
-	DECREF(comma);
 	if (v->ob_size == 1) {
-		t = newstringobject(",");
-		joinstring(&s, t);
-		DECREF(t);
-	}
-	t = newstringobject(")");
-	joinstring(&s, t);
-	DECREF(t);
-	return s;
+		sb_addchars(&sb, ",", 1);
+    }
+	sb_addchars(&sb, ")", 1);
+	return sb_finish(&sb);
 }
 
 static int
@@ -156,6 +203,24 @@ tuplecompare(register tupleobject *v, register tupleobject *w)
 	return v->ob_size - w->ob_size;
 }
 
+/* A tuple is hashable if all its items are */
+static long
+tuplehash(tupleobject *v)
+{
+	register unsigned long x = 0x345678L;
+	register long y;
+	register int i;
+
+	for (i = 0; i < v->ob_size; i++) {
+		if ((y = hashobject(v->ob_item[i])) == -1) {
+			return -1;
+        }
+		x = (1000003 * x) ^ (unsigned long)y;
+	}
+	x ^= v->ob_size;
+	return (long)x == -1 ? -2 : (long)x;
+}
+
 static int
 tuplelength(tupleobject *a)
 {
@@ -245,6 +310,82 @@ static sequence_methods tuple_as_sequence = {
 	0,							/*sq_ass_slice*/
 };
 
+/* Tuple iterators */
+
+typedef struct {
+	OB_HEAD
+	tupleobject *it_seq;	/* NULL once the end has been reached */
+	int it_index;
+} tupleiterobject;
+
+static void
+tupleiter_dealloc(tupleiterobject *it)
+{
+	XDECREF(it->it_seq);
+	DEL(it);
+}
+
+static object *
+tupleiter_iter(tupleiterobject *it)
+{
+	INCREF(it);
+	return (object *)it;
+}
+
+static object *
+tupleiter_next(tupleiterobject *it)
+{
+	tupleobject *op = it->it_seq;
+	object *v;
+
+	if (op == NULL) {
+		return NULL;
+    }
+	if (it->it_index < op->ob_size) {
+		v = op->ob_item[it->it_index++];
+		INCREF(v);
+		return v;
+	}
+	it->it_seq = NULL;
+	DECREF(op);
+	return NULL;
+}
+
+static typeobject Tupleitertype = {
+	OB_HEAD_INIT(&Typetype)
+	0,
+	"tupleiterator",
+	sizeof(tupleiterobject),
+	0,
+	(destructor)tupleiter_dealloc,	/*tp_dealloc*/
+	0,								/*tp_print*/
+	0,								/*tp_getattr*/
+	0,								/*tp_setattr*/
+	0,								/*tp_compare*/
+	0,								/*tp_repr*/
+	0,								/*tp_as_number*/
+	0,								/*tp_as_sequence*/
+	0,								/*tp_as_mapping*/
+	0,								/*tp_hash*/
+	0,								/*tp_methods*/
+	(getiterfunc)tupleiter_iter,	/*tp_iter*/
+	(iternextfunc)tupleiter_next,	/*tp_iternext*/
+};
+
+static object *
+tuple_iter(tupleobject *op)
+{
+	tupleiterobject *it = NEWOBJ(tupleiterobject, &Tupleitertype);
+
+	if (it == NULL) {
+		return NULL;
+    }
+	INCREF(op);
+	it->it_seq = op;
+	it->it_index = 0;
+	return (object *)it;
+}
+
 typeobject Tupletype = {
 	OB_HEAD_INIT(&Typetype)
 	0,
@@ -260,4 +401,7 @@ typeobject Tupletype = {
 	0,							/*tp_as_number*/
 	&tuple_as_sequence,			/*tp_as_sequence*/
 	0,							/*tp_as_mapping*/
+	(hashfunc)tuplehash,		/*tp_hash*/
+	0,							/*tp_methods*/
+	(getiterfunc)tuple_iter,	/*tp_iter*/
 };
@@ -17,7 +17,10 @@ range indices or non-tuple objects are ignored.
 but does decrement the reference count of the item it replaces, if not nil.
 It does *decrement* the reference count if it is *not* inserted in the tuple.
 Similarly, gettupleitem does not increment the returned item's reference
-count. */
+count.
+
+There is only one empty tuple; newtupleobject(0) returns a new reference to
+it.  Freed tuples of up to 20 items are kept for reuse. */
 
 typedef struct {
 	OB_VARHEAD
@@ -26,13 +29,16 @@ typedef struct {
 
 extern typeobject Tupletype;
 
-#define is_tupleobject(op) ((op)->ob_type == &Tupletype)
+#define is_tupleobject(op) (TYPEOF(op) == &Tupletype)
 
 extern object *newtupleobject(int size);
 extern int gettuplesize(object *);
 extern object *gettupleitem(object *, int);
 extern int settupleitem(object *, int, object *);
 
+/* Free the tuples kept for reuse; returns how many there were */
+extern int cleartuplefreelists(void);
+
 /* Macro, trading safety for speed */
 #define GETTUPLEITEM(op, i) ((op)->ob_item[i])
 
@@ -24,7 +24,7 @@ typedef struct {
 } xxobject;
 
 extern typeobject Xxtype;	/* Really static, forward */
-#define is_xxobject(v)	((v)->ob_type == &Xxtype)
+#define is_xxobject(v)	(TYPEOF(v) == &Xxtype)
 
 static xxobject *
 newxxobject(object *arg)